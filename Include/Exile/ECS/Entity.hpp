@@ -1,9 +1,13 @@
 #pragma once
 
 #include <Exile/Reflect/Reflection.hpp>
+#include <Exile/TL/NameTable.hpp>
 #include <Exile/TL/NumericMap.hpp>
 #include <Exile/TL/UUID.hpp>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <vector>
 
 namespace Exi::ECS
 {
@@ -17,7 +21,8 @@ namespace Exi::ECS
         virtual ~Entity();
 
         /**
-         * Get the first component with the given type
+         * Get the first component with the given type, falling back to
+         * a shared component if the entity doesn't have its own
          * @param id
          * @return Pointer to component if found, null otherwise
          */
@@ -35,32 +40,52 @@ namespace Exi::ECS
         }
 
         /**
-         * Fill an array with pointers to components of a given type
+         * Fill an array with pointers to components of a given type,
+         * the entity's own components first and then its shared components
          * @param id
          * @param components
          * @param maxComponents
+         * @param includeDerived Also match components whose class derives from `id`
+         * @return Number of components found
+         */
+        int GetComponentsOfType(Reflect::ClassId id, Component** components, std::size_t maxComponents,
+                                bool includeDerived = false) const;
+
+        /**
+         * Fill an array with pointers to components matching any of the given classes,
+         * the entity's own components first and then its shared components.
+         * Systems can resolve a class and its subclasses once with ClassRegistry::GetDerivedClasses
+         * and pass the result for every entity.
+         * @param classes
+         * @param components
+         * @param maxComponents
          * @return Number of components found
          */
-        int GetComponentsOfType(Reflect::ClassId id, Component** components, std::size_t maxComponents) const;
+        int GetComponentsOfType(std::span<const Reflect::ClassId> classes, Component** components,
+                                std::size_t maxComponents) const;
 
         /**
          * Fill an array with pointers to components of a given type
          * @param id
          * @param components
          * @param maxComponents
+         * @param includeDerived Also match components whose class derives from `C`
          * @return Number of components found
          */
         template <Reflect::ReflectiveClass C> requires std::derived_from<C, Component>
-        int GetComponentsOfType(std::vector<C*>& components) const
+        int GetComponentsOfType(std::vector<C*>& components, bool includeDerived = false) const
         {
-            components.resize(GetComponentCount<C>());
-            return GetComponentsOfType(C::Static::Id, reinterpret_cast<Component**>(components.data()), components.size());
+            components.resize(GetComponentCount<C>(includeDerived));
+            return GetComponentsOfType(C::Static::Id, reinterpret_cast<Component**>(components.data()),
+                                       components.size(), includeDerived);
         }
 
         /**
-         * Attach a component to this entity, given a class ID and instance
+         * Attach a component to this entity, given a class ID and instance.
+         * The entity takes ownership and deletes the component when it is destroyed,
+         * use AttachSharedComponent for components owned elsewhere.
          * @param id
-         * @param component
+         * @param component Heap allocated component, not owned by anything else
          */
         void AttachComponent(Reflect::ClassId id, class Component* component);
 
@@ -76,28 +101,113 @@ namespace Exi::ECS
         }
 
         /**
-         * Return how many components of the given type belong to this entity
+         * Detach a component from this entity and hand ownership back to the caller.
+         * Systems the entity was matched with are not notified.
          * @param id
+         * @param component
+         * @return Detached component, null if it wasn't attached to this entity
+         */
+        std::unique_ptr<Component> DetachComponent(Reflect::ClassId id, Component* component);
+
+        /**
+         * Detach a component from this entity
+         * @param component
+         * @return Detached component, null if it wasn't attached to this entity
+         */
+        template <Reflect::ReflectiveClass C> requires std::derived_from<C, Component>
+        std::unique_ptr<C> DetachComponent(C* component)
+        {
+            return std::unique_ptr<C>(static_cast<C*>(DetachComponent(C::Static::Id, component).release()));
+        }
+
+        /**
+         * Reference a shared component. Shared components are owned by the entity manager
+         * and referenced by any number of entities, they aren't attached to any one entity.
+         * Replaces the entity's previous shared component of the same class.
+         * References aren't persisted: RegionSerializer only writes the entity's own components,
+         * so an entity reloaded by RegionStreamer has to be given its shared components again.
+         * @param id
+         * @param component
+         */
+        void AttachSharedComponent(Reflect::ClassId id, Component* component);
+
+        /**
+         * Reference a shared component
+         * @param component
+         */
+        template <Reflect::ReflectiveClass C> requires std::derived_from<C, Component>
+        void AttachSharedComponent(C* component)
+        {
+            AttachSharedComponent(C::Static::Id, component);
+        }
+
+        /**
+         * Stop referencing a shared component
+         * @param id
+         * @return True if the entity referenced a shared component of the class
+         */
+        bool DetachSharedComponent(Reflect::ClassId id);
+
+        /**
+         * Get the shared component of a class referenced by this entity
+         * @param id
+         * @return Pointer to component if found, null otherwise
+         */
+        [[nodiscard]] Component* GetSharedComponent(Reflect::ClassId id) const;
+
+        /**
+         * Return how many components of the given type belong to this entity, including shared components
+         * @param id
+         * @param includeDerived Also count components whose class derives from `id`
          * @return Component count
          */
-        [[nodiscard]] int GetComponentCount(Reflect::ClassId id) const;
+        [[nodiscard]] int GetComponentCount(Reflect::ClassId id, bool includeDerived = false) const;
 
 
         /**
-         * Return how many components of the given class belong to this entity
+         * Return how many components of the given class belong to this entity, including shared components
+         * @param includeDerived Also count components whose class derives from `C`
          * @return Component count
          */
         template <Reflect::ReflectiveClass C> requires std::derived_from<C, Component>
-        [[nodiscard]] int GetComponentCount() const
+        [[nodiscard]] int GetComponentCount(bool includeDerived = false) const
+        {
+            return GetComponentCount(C::Static::Id, includeDerived);
+        }
+
+        /**
+         * Call `fn(classId, component)` for every component attached to, and owned by, this entity.
+         * Shared components are not included.
+         * @tparam Fn
+         * @param fn
+         */
+        template <class Fn>
+        void ForEachComponent(Fn&& fn) const
         {
-            return GetComponentCount(C::Static::Id);
+            for (auto [id, component] : m_ComponentMap)
+                fn(id, component);
         }
 
         /**
          * Get the name of the entity. Entity names are not guaranteed to be unique.
-         * @return Entity name
+         * @return Entity name, interned in the global name table
+         */
+        [[nodiscard]] std::string_view GetName() const { return TL::NameTable::GetGlobal().Get(m_Name); }
+
+        /**
+         * Get the ID of the entity's name in the global name table
+         * @return Name ID
          */
-        [[nodiscard]] const std::string& GetName() const { return m_Name; }
+        [[nodiscard]] TL::NameTable::NameId GetNameId() const { return m_Name; }
+
+        /**
+         * Get the number of bytes allocated by the entity's component map and shared component references
+         * @return Memory usage in bytes
+         */
+        [[nodiscard]] std::size_t GetComponentMapMemory() const
+        {
+            return m_ComponentMap.GetMemoryUsage() + m_SharedComponents.capacity() * sizeof(m_SharedComponents[0]);
+        }
 
         /**
          * Get the unique ID of the entity.
@@ -123,9 +233,16 @@ namespace Exi::ECS
         Component* m_RootComponent;
         TL::NumericMap<Reflect::ClassId, class Component*> m_ComponentMap;
 
-        std::string m_Name;
+        /** Shared components referenced by this entity, not owned. Entities rarely have more than a few. */
+        std::vector<std::pair<Reflect::ClassId, class Component*>> m_SharedComponents;
+
+        TL::NameTable::NameId m_Name;
         TL::UUID m_UUID;
         const EntityManager* m_EntityManager;
+
+        /** Index in the entity manager's pending list until systems are notified of the entity */
+        static constexpr std::size_t NotPending = SIZE_MAX;
+        std::size_t m_PendingIndex = NotPending;
     };
 
 }
@@ -2,12 +2,17 @@
 
 #include <Exile/ECS/Component.hpp>
 #include <Exile/ECS/Entity.hpp>
+#include <Exile/ECS/Event.hpp>
+#include <Exile/ECS/MemoryStats.hpp>
 #include <Exile/ECS/System.hpp>
 #include <Exile/TL/UUID.hpp>
 #include <Exile/Reflect/Reflection.hpp>
+#include <array>
+#include <atomic>
 #include <shared_mutex>
 #include <mutex>
 #include <memory>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
@@ -17,6 +22,11 @@ namespace Exi::ECS
     /**
      * The entity manager is responsible for keeping track of all entities and
      * distributing them to systems.
+     *
+     * Entities are stored in shards that are locked independently, and IDs are handed out
+     * from per-thread ranges, so any number of threads can add entities concurrently.
+     * New entities are matched against systems in a merge step at the start of the next
+     * TickSystems() or RegisterSystem(), rather than while they are being added.
      */
     class EntityManager
     {
@@ -24,6 +34,22 @@ namespace Exi::ECS
         using EntityId = TL::UUID;
         using SystemId = uint32_t;
 
+        /** Never assigned to an entity, returned when an entity couldn't be added */
+        static inline const EntityId InvalidId { 0, 0, 0, 0 };
+
+        /** Number of independently locked entity shards, a power of two */
+        static constexpr std::size_t ShardCount = 16;
+
+        /** Number of IDs a thread reserves at once */
+        static constexpr std::uint64_t IdRangeSize = 1024;
+
+        /** Where entity ID generation stands, restoring it makes a manager generate the same IDs again */
+        struct IdState
+        {
+            std::uint64_t Prefix = 0;
+            std::uint64_t NextRange = 0;
+        };
+
         EntityManager();
         ~EntityManager();
 
@@ -35,11 +61,115 @@ namespace Exi::ECS
         SystemId RegisterSystem(System* system);
 
         /**
-         * Run ticks for all registered systems
+         * Hand entities added since the last tick to the systems that match them,
+         * then run ticks for all registered systems and swap all event channels
+         * so events pushed during this tick can be read during the next one.
          * @param deltaTime
          */
         void TickSystems(double deltaTime);
 
+        /**
+         * Get the event channel for an event type, creating it if necessary.
+         * The returned reference stays valid for the lifetime of the entity manager.
+         * @tparam E Event type
+         * @return Event channel
+         */
+        template <class E>
+        EventChannel<E>& GetEventChannel()
+        {
+            const std::size_t index = EventChannel<E>::TypeIndex();
+
+            {
+                std::shared_lock lock(m_EventMutex);
+                if (index < m_EventChannels.size() && m_EventChannels[index])
+                    return *static_cast<EventChannel<E>*>(m_EventChannels[index].get());
+            }
+
+            std::unique_lock lock(m_EventMutex);
+            if (index >= m_EventChannels.size())
+                m_EventChannels.resize(index + 1);
+            if (!m_EventChannels[index])
+                m_EventChannels[index] = std::make_unique<EventChannel<E>>();
+            return *static_cast<EventChannel<E>*>(m_EventChannels[index].get());
+        }
+
+        /**
+         * Push an event into its channel
+         * @tparam E Event type
+         * @param event
+         */
+        template <class E>
+        void PushEvent(const E& event)
+        {
+            GetEventChannel<E>().Push(event);
+        }
+
+        /**
+         * Get the events of a type that were published at the end of the last tick
+         * @tparam E Event type
+         * @return Contiguous view of events
+         */
+        template <class E>
+        std::span<const E> GetEvents()
+        {
+            return GetEventChannel<E>().GetEvents();
+        }
+
+        /**
+         * Set the world-wide singleton component of a class, replacing and destroying the previous one
+         * @tparam C Component class
+         * @param component
+         * @return Reference to the singleton
+         */
+        template <Reflect::ReflectiveClass C> requires std::derived_from<C, Component>
+        C& SetSingleton(std::unique_ptr<C>&& component)
+        {
+            const std::size_t index = SingletonIndex<C>();
+            C& singleton = *component;
+
+            std::unique_lock lock(m_SingletonMutex);
+            if (index >= m_Singletons.size())
+                m_Singletons.resize(index + 1);
+            m_Singletons[index] = { C::Static::Id, std::move(component) };
+            return singleton;
+        }
+
+        /**
+         * Get the world-wide singleton component of a class in O(1).
+         * The pointer is only valid until the next SetSingleton for the same class.
+         * @tparam C Component class
+         * @return Pointer to the singleton if set, nullptr otherwise
+         */
+        template <Reflect::ReflectiveClass C> requires std::derived_from<C, Component>
+        C* GetSingleton() const
+        {
+            const std::size_t index = SingletonIndex<C>();
+
+            std::shared_lock lock(m_SingletonMutex);
+            if (index >= m_Singletons.size())
+                return nullptr;
+            return static_cast<C*>(m_Singletons[index].second.get());
+        }
+
+        /**
+         * Create a component that is stored once and can be referenced by any number of
+         * entities with Entity::AttachSharedComponent. It lives as long as the entity manager.
+         * @tparam C Component class
+         * @tparam Args
+         * @param args Constructor arguments
+         * @return Pointer to the shared component
+         */
+        template <Reflect::ReflectiveClass C, class... Args> requires std::derived_from<C, Component>
+        C* CreateSharedComponent(Args&& ...args)
+        {
+            auto component = std::make_unique<C>(std::forward<Args>(args)...);
+            C* shared = component.get();
+
+            std::unique_lock lock(m_SingletonMutex);
+            m_SharedComponents.emplace_back(C::Static::Id, std::move(component));
+            return shared;
+        }
+
         /**
          * Add an entity to this entity manager
          * @param entity
@@ -47,6 +177,27 @@ namespace Exi::ECS
          */
         EntityId AddEntity(std::unique_ptr<Entity>&& entity);
 
+        /**
+         * Add a batch of entities
+         * @param entities Entities to add. Entities whose ID is already in use are left in the
+         *                 vector and untouched, every other entity is taken out of it.
+         * @param ids Optional IDs to assign, one per entity. Random IDs are generated if null.
+         * @param idsOut Optional array receiving the ID of each entity, InvalidId for rejected ones
+         * @return Number of entities added
+         */
+        std::size_t AddEntities(std::vector<std::unique_ptr<Entity>>& entities,
+                                const EntityId* ids = nullptr,
+                                EntityId* idsOut = nullptr);
+
+        /**
+         * Remove a batch of entities and hand their ownership back to the caller
+         * @param ids IDs of entities to remove, unknown IDs are skipped
+         * @param entitiesOut Vector that removed entities are appended to
+         * @return Number of entities removed
+         */
+        std::size_t RemoveEntities(std::span<const EntityId> ids,
+                                   std::vector<std::unique_ptr<Entity>>& entitiesOut);
+
         /**
          * Get an entity by its ID
          * @param id
@@ -54,7 +205,110 @@ namespace Exi::ECS
          */
         const Entity* GetEntity(EntityId id) const;
 
+        /**
+         * Get the number of entities in the manager
+         * @return Entity count
+         */
+        std::size_t GetEntityCount() const;
+
+        /**
+         * Start or stop maintaining an index from entity names to entities.
+         * The index is needed by FindEntity and FindEntities, and is off by default.
+         * @param enabled
+         */
+        void SetNameIndexEnabled(bool enabled);
+
+        /**
+         * Find an entity by name in O(1), the name index must be enabled
+         * @param name
+         * @return Pointer to an entity with the name if one exists, nullptr otherwise
+         */
+        const Entity* FindEntity(std::string_view name) const;
+
+        /**
+         * Find every entity with a name, the name index must be enabled
+         * @param name
+         * @param entitiesOut Vector that matching entities are appended to
+         * @return Number of entities found
+         */
+        std::size_t FindEntities(std::string_view name, std::vector<const Entity*>& entitiesOut) const;
+
+        /**
+         * Walk every entity, system and event channel and total up their memory
+         * @return Memory stats snapshot
+         */
+        MemoryStats CollectMemoryStats() const;
+
+        /**
+         * Dump memory stats to the "ECS" logger from TickSystems() at a fixed interval
+         * @param seconds Interval in seconds of tick time, 0 disables the dump
+         */
+        void SetMemoryStatsInterval(double seconds);
+
+        /**
+         * Get the state of entity ID generation. IDs already reserved by threads
+         * aren't part of it, use SetIdState to drop them.
+         * @return ID state
+         */
+        [[nodiscard]] IdState GetIdState() const;
+
+        /**
+         * Restart entity ID generation from a state, dropping the ranges threads have reserved.
+         * The same IDs are only generated again if entities are created on a single thread,
+         * as every thread reserves its own range of IDs. Not safe while entities are being added.
+         * @param state
+         */
+        void SetIdState(const IdState& state);
+
     private:
+        template <class C>
+        static std::size_t SingletonIndex()
+        {
+            static const std::size_t s_Index = s_NextSingletonIndex++;
+            return s_Index;
+        }
+
+        static inline std::atomic_size_t s_NextSingletonIndex = 0;
+
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex Mutex;
+            std::unordered_map<EntityId, std::unique_ptr<Entity>> Entities;
+
+            /** Entities that systems haven't been notified of yet, removed ones are left as null */
+            std::vector<Entity*> Pending;
+
+            /** Whether entities of this shard are kept in the name index */
+            bool NameIndexed = false;
+        };
+
+        /**
+         * Generate a new entity ID from the calling thread's range
+         * @return Entity ID
+         */
+        EntityId NextId();
+
+        Shard& GetShard(const EntityId& id);
+        const Shard& GetShard(const EntityId& id) const;
+
+        /**
+         * Take a shard's pending entities, caller must hold the shard lock
+         * @param shard
+         * @param pendingOut Receives the entities still pending, in the order they were added
+         */
+        static void TakePending(Shard& shard, std::vector<Entity*>& pendingOut);
+
+        /**
+         * Notify systems of pending entities, caller must hold an exclusive system lock
+         */
+        void MergePending();
+
+        /**
+         * Offer entities to every registered system
+         * @param entities
+         */
+        void NotifySystems(const std::vector<Entity*>& entities);
+
         /**
          * Remove an entity and return its raw pointer
          * @param id
@@ -62,10 +316,63 @@ namespace Exi::ECS
          */
         Entity* RemoveEntity(EntityId id);
 
-        mutable std::shared_mutex m_Mutex;
+        /**
+         * Insert an entity into its shard and queue it for the next merge
+         * @param entity Only moved from if the entity was inserted
+         * @param id
+         * @return False if the ID is already in use
+         */
+        bool InsertEntity(std::unique_ptr<Entity>&& entity, EntityId id);
+
+        /**
+         * Erase an entity and notify systems, caller must hold an exclusive system lock
+         * @param id
+         * @return Entity pointer if it exists, nullptr otherwise
+         */
+        Entity* EraseEntity(EntityId id);
+
+        /**
+         * Swap all event channels
+         */
+        void SwapEvents();
+
+        /**
+         * Remove an entity from the name index, caller must hold the name index lock
+         * @param entity
+         */
+        void UnindexName(const Entity& entity);
+
+        /**
+         * Fill in memory stats, caller must hold a system lock
+         * @param stats
+         */
+        void GatherMemoryStats(MemoryStats& stats) const;
+
+        /** Guards the system list, and the systems themselves while they are ticked or notified */
+        mutable std::shared_mutex m_SystemMutex;
         std::vector<System*> m_Systems;
-        std::unordered_map<EntityId, std::unique_ptr<Entity>> m_Entities;
-        // TODO: Use something faster than unordered_map
+
+        /** Singleton and shared components, declared before the shards so they outlive every entity */
+        mutable std::shared_mutex m_SingletonMutex;
+        std::vector<std::pair<Reflect::ClassId, std::unique_ptr<Component>>> m_Singletons;
+        std::vector<std::pair<Reflect::ClassId, std::unique_ptr<Component>>> m_SharedComponents;
+
+        std::array<Shard, ShardCount> m_Shards;
+
+        /** Entities by interned name, only maintained while enabled */
+        mutable std::shared_mutex m_NameMutex;
+        std::unordered_multimap<TL::NameTable::NameId, Entity*> m_NameIndex;
+
+        /** IDs are a random per-manager prefix followed by a counter, threads key their reserved range by serial */
+        std::atomic_uint64_t m_Serial;
+        std::uint64_t m_IdPrefix;
+        std::atomic_uint64_t m_NextIdRange = 0;
+
+        double m_StatsInterval = 0.0;
+        double m_StatsElapsed = 0.0;
+
+        mutable std::shared_mutex m_EventMutex;
+        std::vector<std::unique_ptr<EventChannelBase>> m_EventChannels;
     };
 
 }
\ No newline at end of file
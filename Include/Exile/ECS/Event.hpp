@@ -0,0 +1,174 @@
+#pragma once
+
+#include <Exile/TL/ThreadIndex.hpp>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace Exi::ECS
+{
+
+    /**
+     * Type-erased base of all event channels, lets the entity manager
+     * flip every channel at the end of a tick without knowing the event types.
+     */
+    class EventChannelBase
+    {
+    public:
+        virtual ~EventChannelBase() = default;
+
+        /**
+         * Publish all events written since the last swap and start a new write phase.
+         * Must not be called while other threads are pushing events.
+         */
+        virtual void Swap() = 0;
+
+        /**
+         * Drop all pending and published events
+         */
+        virtual void Clear() = 0;
+
+        /**
+         * Get the number of bytes held by the channel's event buffers
+         * @return Memory usage in bytes
+         */
+        [[nodiscard]] virtual std::size_t GetMemoryUsage() const = 0;
+
+    protected:
+        static std::size_t NextTypeIndex()
+        {
+            static std::atomic_size_t s_NextIndex = 0;
+            return s_NextIndex++;
+        }
+    };
+
+    /**
+     * Double-buffered channel of events of a single type.
+     *
+     * Any number of threads may push events during a write phase, each thread appends
+     * to its own buffer so pushing never contends with other writers. Swap() concatenates
+     * the write buffers into one contiguous array that readers iterate during the next phase.
+     * @tparam E Event type
+     */
+    template <class E>
+    class EventChannel : public EventChannelBase
+    {
+    public:
+        using Event = E;
+
+        /** Number of threads that get a private write buffer, others share a locked one */
+        static constexpr std::size_t MaxWriters = 64;
+
+        /**
+         * Get the process-wide index of this event type, used to look channels up in O(1)
+         * @return Type index
+         */
+        static std::size_t TypeIndex()
+        {
+            static const std::size_t s_TypeIndex = NextTypeIndex();
+            return s_TypeIndex;
+        }
+
+        EventChannel() = default;
+        ~EventChannel() override = default;
+
+        EventChannel(const EventChannel&) = delete;
+        EventChannel& operator=(const EventChannel&) = delete;
+
+        /**
+         * Push an event, it will become visible to readers after the next swap
+         * @param event
+         */
+        void Push(const Event& event)
+        {
+            Emplace(event);
+        }
+
+        /**
+         * Construct an event in place, it will become visible to readers after the next swap
+         * @tparam Args
+         * @param args
+         */
+        template <class... Args>
+        void Emplace(Args&& ...args)
+        {
+            const std::size_t index = TL::ThreadIndex::Get();
+            if (index < MaxWriters)
+            {
+                auto& buffer = m_Writers[index];
+                if (!buffer)
+                    buffer = std::make_unique<WriteBuffer>();
+                buffer->Events.emplace_back(std::forward<Args>(args)...);
+                return;
+            }
+
+            std::unique_lock lock(m_OverflowMutex);
+            m_Overflow.Events.emplace_back(std::forward<Args>(args)...);
+        }
+
+        void Swap() override
+        {
+            m_Front.clear();
+            for (auto& buffer : m_Writers)
+            {
+                if (buffer)
+                    Drain(*buffer);
+            }
+            Drain(m_Overflow);
+        }
+
+        void Clear() override
+        {
+            m_Front.clear();
+            for (auto& buffer : m_Writers)
+            {
+                if (buffer)
+                    buffer->Events.clear();
+            }
+            m_Overflow.Events.clear();
+        }
+
+        [[nodiscard]] std::size_t GetMemoryUsage() const override
+        {
+            std::size_t bytes = sizeof(*this) + (m_Front.capacity() + m_Overflow.Events.capacity()) * sizeof(Event);
+            for (const auto& buffer : m_Writers)
+            {
+                if (buffer)
+                    bytes += sizeof(WriteBuffer) + buffer->Events.capacity() * sizeof(Event);
+            }
+            return bytes;
+        }
+
+        /**
+         * Get the events published by the last swap
+         * @return Contiguous, stable view of events
+         */
+        [[nodiscard]] std::span<const Event> GetEvents() const { return m_Front; }
+
+        [[nodiscard]] std::size_t GetEventCount() const { return m_Front.size(); }
+    private:
+        struct alignas(64) WriteBuffer
+        {
+            std::vector<Event> Events;
+        };
+
+        void Drain(WriteBuffer& buffer)
+        {
+            // Keep the writer's capacity so steady-state pushes don't allocate
+            m_Front.insert(m_Front.end(),
+                           std::make_move_iterator(buffer.Events.begin()),
+                           std::make_move_iterator(buffer.Events.end()));
+            buffer.Events.clear();
+        }
+
+        std::vector<Event> m_Front;
+        std::array<std::unique_ptr<WriteBuffer>, MaxWriters> m_Writers;
+
+        std::mutex m_OverflowMutex;
+        WriteBuffer m_Overflow;
+    };
+
+}
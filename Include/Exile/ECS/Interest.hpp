@@ -0,0 +1,144 @@
+#pragma once
+
+#include <Exile/ECS/EntityManager.hpp>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Exi::ECS
+{
+
+    /**
+     * Maintains, for every observer, the set of entities within its area of interest.
+     *
+     * Entities are bucketed into a uniform grid of square cells. Each Update() produces
+     * per-observer lists of entities that entered and left the area since the previous
+     * update, alongside the full sorted visible set. Observers whose position and
+     * surrounding cells haven't changed since their last update are skipped entirely.
+     *
+     * Entities are referred to by dense handles, which are not reused until the update
+     * after the entity is removed, so a removed entity is always reported as having left.
+     */
+    class InterestManager
+    {
+    public:
+        using EntityId = EntityManager::EntityId;
+        using Handle   = std::uint32_t;
+        static constexpr Handle InvalidHandle = UINT32_MAX;
+
+        /**
+         * @param cellSize Width and height of a grid cell, ideally close to the typical interest radius
+         */
+        explicit InterestManager(float cellSize);
+
+        /**
+         * Start tracking an entity at a position
+         * @param id
+         * @param x
+         * @param y
+         * @return Handle of the tracked entity
+         */
+        Handle AddEntity(const EntityId& id, float x, float y);
+
+        /**
+         * Update the position of a tracked entity
+         * @param handle
+         * @param x
+         * @param y
+         */
+        void MoveEntity(Handle handle, float x, float y);
+
+        /**
+         * Stop tracking an entity, it is also removed as an observer
+         * @param handle
+         */
+        void RemoveEntity(Handle handle);
+
+        /**
+         * Make a tracked entity an observer
+         * @param handle
+         * @param radius Radius of the observer's area of interest
+         */
+        void AddObserver(Handle handle, float radius);
+
+        /**
+         * Stop computing interest sets for an entity
+         * @param handle
+         */
+        void RemoveObserver(Handle handle);
+
+        /**
+         * Recompute the interest sets of all observers
+         */
+        void Update();
+
+        /** Entities that came into the observer's area during the last update */
+        [[nodiscard]] std::span<const Handle> GetEntered(Handle observer) const;
+
+        /** Entities that left the observer's area, or were removed, during the last update */
+        [[nodiscard]] std::span<const Handle> GetLeft(Handle observer) const;
+
+        /** All entities in the observer's area, sorted by handle */
+        [[nodiscard]] std::span<const Handle> GetVisible(Handle observer) const;
+
+        [[nodiscard]] const EntityId& GetEntityId(Handle handle) const { return m_Ids[handle]; }
+        [[nodiscard]] std::size_t GetEntityCount() const { return m_Ids.size() - m_FreeHandles.size() - m_RemovedHandles.size(); }
+        [[nodiscard]] std::size_t GetObserverCount() const { return m_Observers.size(); }
+    private:
+        using CellKey = std::uint64_t;
+        static constexpr std::uint32_t NoObserver = UINT32_MAX;
+
+        struct Cell
+        {
+            std::vector<Handle> Members;
+
+            /** Update number of the last membership change or movement within the cell */
+            std::uint64_t LastChanged = 0;
+        };
+
+        struct Observer
+        {
+            Handle Entity;
+            float Radius;
+
+            /** Position and update number of the last recomputation */
+            float LastX, LastY;
+            std::uint64_t LastUpdated = 0;
+
+            std::vector<Handle> Visible;
+            std::vector<Handle> Entered;
+            std::vector<Handle> Left;
+        };
+
+        [[nodiscard]] std::int32_t ToCell(float v) const;
+        [[nodiscard]] static CellKey MakeKey(std::int32_t cx, std::int32_t cy);
+
+        void InsertIntoCell(Handle handle, CellKey key);
+        void RemoveFromCell(Handle handle);
+        void UpdateObserver(Observer& observer);
+
+        const float m_CellSize;
+        const float m_InverseCellSize;
+        std::uint64_t m_UpdateCount = 1;
+
+        /** Entity state, indexed by handle */
+        std::vector<EntityId> m_Ids;
+        std::vector<float> m_X;
+        std::vector<float> m_Y;
+        std::vector<CellKey> m_CellKeys;
+        std::vector<std::uint32_t> m_CellSlots;
+        std::vector<std::uint32_t> m_ObserverSlots;
+        std::vector<std::uint8_t> m_Alive;
+
+        std::vector<Handle> m_FreeHandles;
+        std::vector<Handle> m_RemovedHandles;
+
+        std::unordered_map<CellKey, Cell> m_Cells;
+        std::vector<Observer> m_Observers;
+
+        /** Scratch buffer for building visible sets */
+        std::vector<Handle> m_Scratch;
+    };
+
+}
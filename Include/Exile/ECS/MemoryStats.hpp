@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Exile/Reflect/Reflection.hpp>
+#include <Exile/Runtime/Logger.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace Exi::ECS
+{
+
+    /**
+     * Instance count and memory of a single component class
+     */
+    struct ComponentMemoryStats
+    {
+        Reflect::ClassId Class = 0;
+        const char* Name = "";
+        std::size_t Count = 0;
+        std::size_t Bytes = 0;
+    };
+
+    /**
+     * Snapshot of the memory held by an entity manager, split into component data
+     * and the bookkeeping around it
+     */
+    struct MemoryStats
+    {
+        std::size_t EntityCount = 0;
+
+        /** Entity objects themselves */
+        std::size_t EntityBytes = 0;
+
+        /** The global name table that entity names are interned in, and the manager's name index */
+        std::size_t NameBytes = 0;
+
+        /** Per-entity component maps, rows and nodes, and shared component references */
+        std::size_t ComponentMapBytes = 0;
+
+        /** Entity shards, hash map buckets and nodes, entities waiting to be merged, and singleton tables */
+        std::size_t StorageBytes = 0;
+
+        /** Entity lists held by systems */
+        std::size_t SystemBytes = 0;
+
+        /** Event channel buffers */
+        std::size_t EventBytes = 0;
+
+        /** Per-class component memory, largest first. Singleton and shared components are counted once. */
+        std::vector<ComponentMemoryStats> Components;
+
+        [[nodiscard]] std::size_t GetComponentBytes() const;
+        [[nodiscard]] std::size_t GetOverheadBytes() const;
+        [[nodiscard]] std::size_t GetTotalBytes() const { return GetComponentBytes() + GetOverheadBytes(); }
+
+        /**
+         * Find the stats of a component class
+         * @param id
+         * @return Pointer to stats if any instances exist, nullptr otherwise
+         */
+        [[nodiscard]] const ComponentMemoryStats* GetComponent(Reflect::ClassId id) const;
+
+        /**
+         * Write the stats to a logger, one line per category and component class
+         * @param logger
+         */
+        void Dump(Runtime::Logger& logger) const;
+    };
+
+}
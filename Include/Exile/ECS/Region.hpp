@@ -0,0 +1,294 @@
+#pragma once
+
+#include <Exile/ECS/Entity.hpp>
+#include <Exile/ECS/EntityManager.hpp>
+#include <Exile/Runtime/Filesystem.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Exi::ECS
+{
+
+    /**
+     * Coordinates of a region cell within a 2D world
+     */
+    struct RegionCoord
+    {
+        std::int32_t X = 0;
+        std::int32_t Y = 0;
+
+        [[nodiscard]] std::uint64_t Key() const
+        {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(X)) << 32) | static_cast<std::uint32_t>(Y);
+        }
+
+        /** Chebyshev distance, the number of rings between two cells */
+        [[nodiscard]] std::int32_t Distance(const RegionCoord& other) const
+        {
+            return std::max(std::abs(X - other.X), std::abs(Y - other.Y));
+        }
+
+        bool operator==(const RegionCoord& other) const { return X == other.X && Y == other.Y; }
+    };
+
+    namespace RegionSerializer
+    {
+
+        /**
+         * Component classes and their serializable fields, resolved from the class registry up front.
+         *
+         * The class registry isn't thread-safe: classes may be registered lazily at any time, and
+         * registering one renumbers the hierarchy. Other threads serialize entities through a table
+         * built on the thread that registers classes instead of querying the registry themselves.
+         */
+        class ClassTable
+        {
+        public:
+            struct Entry
+            {
+                const Reflect::Class* Class;
+
+                /** Serializable fields of the class and its super classes */
+                std::vector<const Reflect::Field*> Fields;
+            };
+
+            /** Resolve every registered component class, must run on the thread that registers classes */
+            ClassTable();
+
+            /**
+             * Find a component class
+             * @param id
+             * @return Entry if `id` is a registered component class, nullptr otherwise
+             */
+            [[nodiscard]] const Entry* Find(Reflect::ClassId id) const;
+
+            /** Number of registered classes when the table was built */
+            [[nodiscard]] std::size_t GetRegistryCount() const { return m_RegistryCount; }
+        private:
+            std::unordered_map<Reflect::ClassId, Entry> m_Entries;
+            std::size_t m_RegistryCount;
+        };
+
+        /**
+         * Serialize entities and their reflected component fields into a byte buffer.
+         * Only fields with primitive types are written, pointers and objects are skipped.
+         * Shared components belong to the entity manager and aren't written.
+         * @param entities
+         * @param classes
+         * @param bytesOut
+         */
+        void Write(const std::vector<const Entity*>& entities, const ClassTable& classes,
+                   std::vector<std::uint8_t>& bytesOut);
+
+        /**
+         * Serialize owned entities into a byte buffer
+         * @param entities
+         * @param classes
+         * @param bytesOut
+         */
+        void Write(const std::vector<std::unique_ptr<Entity>>& entities, const ClassTable& classes,
+                   std::vector<std::uint8_t>& bytesOut);
+
+        /**
+         * Serialize owned entities, resolving classes on the calling thread
+         * @param entities
+         * @param bytesOut
+         */
+        void Write(const std::vector<std::unique_ptr<Entity>>& entities, std::vector<std::uint8_t>& bytesOut);
+
+        /**
+         * Deserialize entities from a byte buffer.
+         * Components of classes missing from the table are skipped.
+         * @param bytes
+         * @param classes
+         * @param entitiesOut
+         * @param idsOut Unique ID of each entity when it was written
+         * @return True if the buffer was valid, false otherwise
+         */
+        bool Read(const std::vector<std::uint8_t>& bytes, const ClassTable& classes,
+                  std::vector<std::unique_ptr<Entity>>& entitiesOut,
+                  std::vector<EntityManager::EntityId>& idsOut);
+
+        /**
+         * Deserialize entities, resolving classes on the calling thread.
+         * Component classes must already be registered with the class registry.
+         * @param bytes
+         * @param entitiesOut
+         * @param idsOut Unique ID of each entity when it was written
+         * @return True if the buffer was valid, false otherwise
+         */
+        bool Read(const std::vector<std::uint8_t>& bytes,
+                  std::vector<std::unique_ptr<Entity>>& entitiesOut,
+                  std::vector<EntityManager::EntityId>& idsOut);
+
+        /**
+         * Estimate the resident memory of an entity and its components
+         * @param entity
+         * @return Size in bytes
+         */
+        std::size_t EstimateMemory(const Entity& entity);
+
+    }
+
+    /**
+     * Streams cell-partitioned sets of entities between disk and an entity manager.
+     *
+     * Region files are read, and their entities constructed, on a background thread.
+     * Finished loads are inserted into the entity manager in one batch by Update(),
+     * which is meant to be called from the simulation thread once per tick and never
+     * waits on I/O. Regions furthest from the focus are evicted and written back
+     * in the background when the resident set exceeds the memory budget.
+     *
+     * Evicted entities are handed back once written and destroyed by a later Update(),
+     * or by the destructor, so component destructors run on the calling thread. When
+     * reloaded they come back with their own components only, references to shared
+     * components are dropped and have to be attached again.
+     *
+     * The streamer must be used from the thread that registers classes. The background
+     * thread never queries the class registry, it works from a RegionSerializer::ClassTable
+     * that is rebuilt on the calling thread whenever new classes were registered.
+     */
+    class RegionStreamer
+    {
+    public:
+        /**
+         * @param manager Entity manager that resident entities live in
+         * @param filesystem Filesystem to read and write region files through
+         * @param directory Virtual directory containing region files
+         * @param memoryBudget Estimated bytes of resident entities before regions get evicted
+         */
+        RegionStreamer(EntityManager& manager,
+                       Runtime::Filesystem& filesystem,
+                       Runtime::Path directory,
+                       std::size_t memoryBudget);
+
+        /** Stops the background thread after all pending writes have finished */
+        ~RegionStreamer();
+
+        RegionStreamer(const RegionStreamer&) = delete;
+        RegionStreamer& operator=(const RegionStreamer&) = delete;
+
+        /**
+         * Add an entity to a region. If the region is not resident it is requested,
+         * and the entity is added along with the region's contents once it is loaded.
+         * @param region
+         * @param entity
+         */
+        void AddEntity(RegionCoord region, std::unique_ptr<Entity>&& entity);
+
+        /**
+         * Queue a region to be loaded in the background if it isn't resident or loading
+         * @param region
+         */
+        void RequestRegion(RegionCoord region);
+
+        /**
+         * Load regions around a focus, insert finished loads, and evict far-away regions
+         * while over the memory budget. Regions within `radius` of the focus are never evicted.
+         * @param focus Region the simulation is centered on
+         * @param radius Number of rings of regions around the focus to keep resident
+         */
+        void Update(RegionCoord focus, std::int32_t radius);
+
+        /**
+         * Write every resident region back to disk without evicting it
+         */
+        void SaveAll();
+
+        /**
+         * Get the IDs of the entities in a resident region
+         * @param region
+         * @return View of entity IDs, empty if the region isn't resident
+         */
+        [[nodiscard]] std::span<const EntityManager::EntityId> GetEntities(RegionCoord region) const;
+
+        [[nodiscard]] bool IsResident(RegionCoord region) const;
+        [[nodiscard]] std::size_t GetResidentCount() const;
+        [[nodiscard]] std::size_t GetMemoryUsage() const { return m_MemoryUsage; }
+        [[nodiscard]] std::size_t GetMemoryBudget() const { return m_MemoryBudget; }
+        void SetMemoryBudget(std::size_t memoryBudget) { m_MemoryBudget = memoryBudget; }
+    private:
+        enum class RegionState
+        {
+            Loading,
+            Resident
+        };
+
+        struct Region
+        {
+            RegionCoord Coord;
+            RegionState State = RegionState::Loading;
+            std::vector<EntityManager::EntityId> Entities;
+            std::vector<std::unique_ptr<Entity>> Pending;
+            std::size_t Memory = 0;
+        };
+
+        struct Job
+        {
+            /** Load a region, serialize and write evicted entities, or write already serialized bytes */
+            enum { Load, Save, Write } Type;
+            RegionCoord Coord;
+            std::vector<std::unique_ptr<Entity>> Entities;
+            std::vector<std::uint8_t> Bytes;
+
+            /** Classes as of when the job was queued, the worker never touches the registry */
+            std::shared_ptr<const RegionSerializer::ClassTable> Classes;
+        };
+
+        struct LoadResult
+        {
+            RegionCoord Coord;
+            std::vector<std::unique_ptr<Entity>> Entities;
+            std::vector<EntityManager::EntityId> Ids;
+        };
+
+        [[nodiscard]] Runtime::Path GetRegionPath(RegionCoord region) const;
+
+        /** Get the class table, rebuilt first if classes were registered since the last call */
+        const std::shared_ptr<const RegionSerializer::ClassTable>& GetClassTable();
+
+        void PushJob(Job&& job);
+        void WorkerMain();
+        void LoadRegion(RegionCoord region, const RegionSerializer::ClassTable& classes, LoadResult& result);
+        void WriteRegion(RegionCoord region, const std::vector<std::uint8_t>& bytes);
+
+        void Integrate(LoadResult& result);
+        void Evict(Region& region, bool keepResident);
+
+        EntityManager& m_Manager;
+        Runtime::Filesystem& m_Filesystem;
+        Runtime::Logger& m_Logger;
+        const Runtime::Path m_Directory;
+        std::size_t m_MemoryBudget;
+
+        /** Regions owned by the simulation thread */
+        std::unordered_map<std::uint64_t, Region> m_Regions;
+        std::size_t m_MemoryUsage = 0;
+        std::shared_ptr<const RegionSerializer::ClassTable> m_Classes;
+
+        /** Jobs for the background thread, processed in order */
+        std::mutex m_JobMutex;
+        std::condition_variable m_JobSignal;
+        std::deque<Job> m_Jobs;
+        bool m_Stopping = false;
+
+        /** Loads finished by the background thread, waiting to be inserted */
+        std::mutex m_ResultMutex;
+        std::vector<LoadResult> m_Results;
+
+        /** Evicted entities the background thread is done with, waiting to be destroyed */
+        std::vector<std::unique_ptr<Entity>> m_Written;
+
+        std::thread m_Worker;
+    };
+
+}
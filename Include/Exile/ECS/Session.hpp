@@ -0,0 +1,166 @@
+#pragma once
+
+#include <Exile/ECS/EntityManager.hpp>
+#include <Exile/Runtime/Filesystem.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Exi::ECS
+{
+
+    /**
+     * Records the inputs of a simulation session, the commands applied each tick,
+     * tick delta times, RNG seeds and the entity manager's ID state, to a compact
+     * binary log that SessionPlayer can replay deterministically.
+     *
+     * Entity IDs are only replayed faithfully if the session creates entities on a
+     * single thread: every thread reserves its own range of IDs, so IDs handed out
+     * on several threads depend on scheduling. UUID seeds likewise only apply to the
+     * thread that records or replays them.
+     *
+     * Commands are opaque to the recorder, they are identified by an application
+     * defined type and stored as raw bytes. Records are buffered in memory and
+     * written out in large chunks.
+     */
+    class SessionRecorder
+    {
+    public:
+        /**
+         * Start recording a session. The manager's ID state is recorded, and the calling
+         * thread's UUID generator is seeded with `seed`.
+         * @param filesystem
+         * @param path Virtual path of the session log, it is overwritten
+         * @param manager Entity manager the session runs on, IDs it reserved before are dropped
+         * @param seed Initial seed, recorded first in the log
+         */
+        SessionRecorder(Runtime::Filesystem& filesystem, const Runtime::Path& path, EntityManager& manager,
+                        std::uint64_t seed);
+
+        /** Writes out the end of the session */
+        ~SessionRecorder();
+
+        SessionRecorder(const SessionRecorder&) = delete;
+        SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+        [[nodiscard]] bool IsOpen() const { return m_File.IsValid(); }
+
+        /**
+         * Reseed the calling thread's UUID generator and record the seed
+         * @param seed
+         */
+        void RecordSeed(std::uint64_t seed);
+
+        /**
+         * Record a command that the application applies during the current tick
+         * @param type Application-defined command type
+         * @param data
+         * @param size
+         */
+        void RecordCommand(std::uint32_t type, const void* data, std::size_t size);
+
+        /**
+         * Record a trivially copyable command
+         * @tparam T
+         * @param type Application-defined command type
+         * @param command
+         */
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        void RecordCommand(std::uint32_t type, const T& command)
+        {
+            RecordCommand(type, &command, sizeof(T));
+        }
+
+        /**
+         * Record the end of a tick and run it
+         * @param manager
+         * @param deltaTime
+         */
+        void Tick(EntityManager& manager, double deltaTime);
+
+        /**
+         * Write buffered records to the log
+         */
+        void Flush();
+
+        [[nodiscard]] std::size_t GetTickCount() const { return m_TickCount; }
+    private:
+        void WriteVarInt(std::uint64_t value);
+
+        Runtime::FileHandle m_File;
+        std::vector<std::uint8_t> m_Buffer;
+        std::size_t m_TickCount = 0;
+    };
+
+    /**
+     * Replays a session recorded by SessionRecorder through an entity manager,
+     * headless and as fast as possible.
+     */
+    class SessionPlayer
+    {
+    public:
+        using CommandHandler = std::function<void(std::uint32_t type, std::span<const std::uint8_t> data)>;
+
+        /**
+         * Load a session log. Nothing is applied until the first Step.
+         * @param filesystem
+         * @param path Virtual path of the session log
+         */
+        SessionPlayer(Runtime::Filesystem& filesystem, const Runtime::Path& path);
+
+        /**
+         * @return True if the log was loaded and its header is valid
+         */
+        [[nodiscard]] bool IsValid() const { return m_Valid; }
+
+        /**
+         * Set the function that applies recorded commands to the simulation
+         * @param handler
+         */
+        void SetCommandHandler(CommandHandler handler) { m_CommandHandler = std::move(handler); }
+
+        /**
+         * Apply the ID state, seeds and commands of the next tick, then tick the manager.
+         * Seeds are applied to the calling thread's UUID generator.
+         * @param manager
+         * @return False once the end of the session is reached or the log is corrupt
+         */
+        bool Step(EntityManager& manager);
+
+        /**
+         * Replay every remaining tick
+         * @param manager
+         * @return Number of ticks replayed
+         */
+        std::size_t Run(EntityManager& manager);
+
+        [[nodiscard]] std::size_t GetTickCount() const { return m_TickCount; }
+
+        /**
+         * @return True if the whole log was replayed without errors
+         */
+        [[nodiscard]] bool IsFinished() const { return m_Finished; }
+    private:
+        bool ReadVarInt(std::uint64_t& value);
+
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        bool Read(T& value)
+        {
+            if (m_Offset + sizeof(T) > m_Bytes.size())
+                return false;
+            std::memcpy(&value, m_Bytes.data() + m_Offset, sizeof(T));
+            m_Offset += sizeof(T);
+            return true;
+        }
+
+        std::vector<std::uint8_t> m_Bytes;
+        std::size_t m_Offset = 0;
+        std::size_t m_TickCount = 0;
+        bool m_Valid = false;
+        bool m_Finished = false;
+        CommandHandler m_CommandHandler;
+    };
+
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <Exile/ECS/Component.hpp>
+#include <Exile/ECS/Entity.hpp>
+#include <Exile/ECS/System.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+namespace Exi::ECS
+{
+
+    /**
+     * System that keeps every entity with a component of type C ordered by a key
+     * extracted from that component, e.g. a render layer or depth.
+     *
+     * Keys are refreshed on every Sort(). When only a few keys changed, the changed entries
+     * are taken out, insertion sorted among themselves and merged back into the untouched,
+     * still sorted entries in a single linear pass. A full LSD radix sort is used once
+     * churn is high.
+     *
+     * Removed entities are only noted, their entries are dropped by the next Sort() in the
+     * same pass that refreshes keys. Until then ForEach() skips them, but GetEntries() and
+     * GetEntities() still list them.
+     * @tparam C Component type holding the sort key
+     */
+    template <Reflect::ReflectiveClass C> requires std::derived_from<C, Component>
+    class SortedGroup : public System
+    {
+    public:
+        using KeyFunction = std::uint32_t(*)(const C&);
+
+        struct Entry
+        {
+            std::uint32_t Key;
+            ECS::Entity* Entity;
+            C* Component;
+        };
+
+        /** Groups smaller than this are always insertion sorted */
+        static constexpr std::size_t MinRadixSize = 256;
+
+        /**
+         * @param keyFunction Function extracting the sort key from a component
+         * @param radixThreshold Fraction of changed keys above which a radix sort is used
+         */
+        explicit SortedGroup(KeyFunction keyFunction, float radixThreshold = 0.125f)
+            : m_KeyFunction(keyFunction), m_RadixThreshold(radixThreshold)
+        {
+
+        }
+
+        /**
+         * Default tick, keeps the group sorted
+         * @param deltaTime
+         */
+        void Tick(double deltaTime) override
+        {
+            Sort();
+        }
+
+        bool NotifyEntity(const Entity& entity) override
+        {
+            return entity.GetComponent<C>() != nullptr;
+        }
+
+        bool NotifyEntityRemoved(Entity& entity) override
+        {
+            // Searching and erasing here would make removing k entities O(n*k)
+            if (!NotifyEntity(entity))
+                return false;
+            return m_Removed.insert(&entity).second;
+        }
+
+        void AddEntity(Entity& entity) override
+        {
+            // A removed entity, or a new one at its address, has to lose its old entries first
+            if (!m_Removed.empty() && m_Removed.contains(&entity))
+                DropRemoved();
+
+            System::AddEntity(entity);
+
+            C* component = entity.GetComponent<C>();
+            m_Pending.push_back({ m_KeyFunction(*component), &entity, component });
+        }
+
+        /**
+         * Refresh every key and restore sorted order
+         */
+        void Sort()
+        {
+            const bool removed = !m_Removed.empty();
+            if (removed)
+                std::erase_if(m_Pending, [this](const Entry& entry) { return IsRemoved(entry); });
+
+            // Pull entries whose key changed out, the rest stay sorted relative to each other
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < m_Entries.size(); i++)
+            {
+                Entry entry = m_Entries[i];
+                if (removed && IsRemoved(entry))
+                    continue;
+
+                const std::uint32_t key = m_KeyFunction(*entry.Component);
+                if (key != entry.Key)
+                {
+                    entry.Key = key;
+                    m_Pending.push_back(entry);
+                }
+                else
+                {
+                    m_Entries[kept++] = entry;
+                }
+            }
+
+            m_Removed.clear();
+            if (m_Pending.empty() && !removed)
+                return;
+
+            const std::size_t total = kept + m_Pending.size();
+            if (m_Pending.empty())
+            {
+                // Only removals, the kept entries are still sorted
+                m_Entries.resize(kept);
+            }
+            else if (total >= MinRadixSize &&
+                static_cast<float>(m_Pending.size()) > static_cast<float>(total) * m_RadixThreshold)
+            {
+                m_Entries.resize(total);
+                std::copy(m_Pending.begin(), m_Pending.end(), m_Entries.begin() + kept);
+                RadixSort();
+            }
+            else
+            {
+                InsertionSort(m_Pending);
+                m_Entries.resize(total);
+                MergePending(kept);
+            }
+
+            m_Pending.clear();
+            m_Entities.resize(m_Entries.size());
+            for (std::size_t i = 0; i < m_Entries.size(); i++)
+                m_Entities[i] = m_Entries[i].Entity;
+        }
+
+        /**
+         * Call a function for every entity in key order
+         * @tparam Fn Callable taking (Entity&, C&)
+         * @param fn
+         */
+        template <class Fn>
+        void ForEach(Fn&& fn) const
+        {
+            const bool removed = !m_Removed.empty();
+            for (const auto& entry : m_Entries)
+            {
+                if (!removed || !IsRemoved(entry))
+                    fn(*entry.Entity, *entry.Component);
+            }
+        }
+
+        /**
+         * Get the entries in key order, as of the last Sort().
+         * Entities added since then aren't included until the next Sort(), and removed ones
+         * aren't dropped until then either.
+         * @return Contiguous view of entries
+         */
+        [[nodiscard]] std::span<const Entry> GetEntries() const { return m_Entries; }
+    private:
+        [[nodiscard]] bool IsRemoved(const Entry& entry) const { return m_Removed.contains(entry.Entity); }
+
+        /** Drop the entries of removed entities right away, outside of Sort() */
+        void DropRemoved()
+        {
+            auto removed = [this](const Entry& entry) { return IsRemoved(entry); };
+            std::erase_if(m_Entries, removed);
+            std::erase_if(m_Pending, removed);
+            m_Entities.erase(std::remove_if(m_Entities.begin(), m_Entities.end(),
+                                            [this](const Entity* entity) { return m_Removed.contains(entity); }),
+                             m_Entities.end());
+            m_Removed.clear();
+        }
+
+        static void InsertionSort(std::vector<Entry>& entries)
+        {
+            for (std::size_t i = 1; i < entries.size(); i++)
+            {
+                const Entry entry = entries[i];
+                std::size_t j = i;
+                for (; j > 0 && entries[j - 1].Key > entry.Key; j--)
+                    entries[j] = entries[j - 1];
+                entries[j] = entry;
+            }
+        }
+
+        /**
+         * Merge the sorted pending entries into the first `kept` entries, back to front
+         * so the merge can happen in place
+         * @param kept
+         */
+        void MergePending(std::size_t kept)
+        {
+            std::size_t out = m_Entries.size();
+            std::size_t pending = m_Pending.size();
+            while (pending > 0)
+            {
+                if (kept > 0 && m_Entries[kept - 1].Key > m_Pending[pending - 1].Key)
+                    m_Entries[--out] = m_Entries[--kept];
+                else
+                    m_Entries[--out] = m_Pending[--pending];
+            }
+        }
+
+        void RadixSort()
+        {
+            std::array<std::array<std::size_t, 256>, 4> counts = {};
+            for (const auto& entry : m_Entries)
+            {
+                for (int digit = 0; digit < 4; digit++)
+                    counts[digit][(entry.Key >> (digit * 8)) & 0xFF]++;
+            }
+
+            m_Scratch.resize(m_Entries.size());
+            for (int digit = 0; digit < 4; digit++)
+            {
+                auto& count = counts[digit];
+
+                // Every key has the same byte here, the pass wouldn't move anything
+                const std::uint32_t shift = digit * 8;
+                if (count[(m_Entries[0].Key >> shift) & 0xFF] == m_Entries.size())
+                    continue;
+
+                std::size_t offset = 0;
+                for (auto& c : count)
+                {
+                    const std::size_t n = c;
+                    c = offset;
+                    offset += n;
+                }
+
+                for (const auto& entry : m_Entries)
+                    m_Scratch[count[(entry.Key >> shift) & 0xFF]++] = entry;
+                m_Entries.swap(m_Scratch);
+            }
+        }
+
+        const KeyFunction m_KeyFunction;
+        const float m_RadixThreshold;
+
+        std::vector<Entry> m_Entries;
+
+        /** Entries that were added or whose key changed, waiting to be merged back in */
+        std::vector<Entry> m_Pending;
+        std::vector<Entry> m_Scratch;
+
+        /** Entities removed since the last Sort(), their entries are still in place */
+        std::unordered_set<const Entity*> m_Removed;
+    };
+
+}
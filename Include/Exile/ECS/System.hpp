@@ -1,7 +1,7 @@
 #pragma once
 
 #include <Exile/ECS/Entity.hpp>
-#include <vector>
+#include <Exile/TL/SmallVector.hpp>
 
 namespace Exi::ECS
 {
@@ -9,6 +9,9 @@ namespace Exi::ECS
     DefineClass(System)
     {
     public:
+        /** Most systems only track a handful of entities, those stay inline */
+        using EntityList = TL::SmallVector<Entity*, 8>;
+
         System() = default;
         virtual ~System() = default;
 
@@ -39,13 +42,13 @@ namespace Exi::ECS
          */
         virtual void AddEntity(Entity& entity);
 
-        [[nodiscard]] const std::vector<Entity*>& GetEntities() const { return m_Entities; }
+        [[nodiscard]] const EntityList& GetEntities() const { return m_Entities; }
     protected:
         /**
          * Entities referenced by this system.
          * The system does NOT have ownership over these entities.
          */
-        std::vector<Entity*> m_Entities;
+        EntityList m_Entities;
     };
 
 }
\ No newline at end of file
@@ -20,6 +20,10 @@ public:
         if (IsClassRegistered(id))
             return;
 
+        // Super classes are registered first so the hierarchy is always complete
+        if constexpr (!std::same_as<typename Clazz::Super, ClassBase>)
+            RegisterClass<typename Clazz::Super>();
+
         auto clazz = Class::FromStaticClass<Clazz>();
         if constexpr (StaticConstructible<Clazz>)
             Clazz::StaticInitialize(RegisterClass(clazz, id));
@@ -44,6 +48,12 @@ public:
      */
     bool IsClassRegistered(ClassId id) const;
 
+    /**
+     * Get the number of registered classes. Classes are never unregistered, so a changed
+     * count means new classes were registered.
+     */
+    [[nodiscard]] std::size_t GetClassCount() const { return m_ClassMap.size(); }
+
     /**
      * Get a reference to reflection information about a class,
      * registers the class if it isn't already registered
@@ -65,6 +75,22 @@ public:
      */
     const Class* GetClass(ClassId id) const;
 
+    /**
+     * Check whether a class is, or is derived from, another class
+     * @param id Class ID
+     * @param baseId Base class ID
+     * @return True if both classes are registered and `id` is `baseId` or one of its subclasses
+     */
+    bool IsA(ClassId id, ClassId baseId) const;
+
+    /**
+     * Get a class and all of its registered subclasses.
+     * The view is invalidated when another class is registered.
+     * @param id Class ID
+     * @return View of class IDs in depth-first order, starting with `id`. Empty if `id` isn't registered.
+     */
+    std::span<const ClassId> GetDerivedClasses(ClassId id) const;
+
     /**
      * Debug function to print information about a class
      * @param id  Class ID
@@ -79,5 +105,15 @@ private:
     ClassRegistry(ClassRegistry&) = delete;
     ClassRegistry& operator=(const ClassRegistry&) = delete;
 
-    std::unordered_map<ClassId, Class> m_ClassMap;
+    /**
+     * Re-number the class hierarchy with depth-first pre/post-order intervals,
+     * run whenever a class is registered.
+     */
+    void RebuildHierarchy();
+
+    std::unordered_map<ClassId, Class, std::hash<ClassId>, std::equal_to<ClassId>,
+                       TL::PoolAllocator<std::pair<const ClassId, Class>>> m_ClassMap;
+
+    /** Class IDs in depth-first pre-order, subclasses of a class follow it contiguously */
+    std::vector<ClassId> m_Hierarchy;
 };
\ No newline at end of file
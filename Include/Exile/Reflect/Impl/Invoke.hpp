@@ -20,13 +20,17 @@ class RuntimeFunction
 {
 public:
     using FnType = void* (ClassBase::*)(...);
-    RuntimeFunction(FnType fn, TL::Type returnType, std::vector<TL::Type>&& argTypes)
+
+    /** Argument types, inline for up to 6 arguments */
+    using ArgTypes = TL::SmallVector<TL::Type, 6>;
+
+    RuntimeFunction(FnType fn, TL::Type returnType, ArgTypes&& argTypes)
             : m_Function(fn), m_ReturnType(returnType), m_ArgTypes(std::move(argTypes)) { }
 
     template <class Traits, std::size_t... Indices>
     [[nodiscard]] static inline RuntimeFunction From(FnType Fn, std::index_sequence<Indices...>)
     {
-        std::vector<TL::Type> types;
+        ArgTypes types;
         (types.push_back(TL::TypeValueOf<typename Traits::template Arg<Indices>::Type>::Value), ...);
         return RuntimeFunction(Fn, TL::TypeValueOf<typename Traits::Return>::Value, std::move(types));
     }
@@ -76,5 +80,5 @@ public:
 private:
     FnType m_Function;
     TL::Type m_ReturnType;
-    std::vector<TL::Type> m_ArgTypes;
+    ArgTypes m_ArgTypes;
 };
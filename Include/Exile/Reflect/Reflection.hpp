@@ -3,8 +3,12 @@
 #include <Exile/Reflect/Compiler.hpp>
 #include <cassert>
 #include <concepts>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
+#include <Exile/TL/PoolAllocator.hpp>
+#include <Exile/TL/SmallVector.hpp>
 #include <Exile/TL/Type.hpp>
 
 namespace Exi::Reflect
@@ -328,15 +332,32 @@ namespace Exi::Reflect
     public:
         friend class ClassRegistry;
 
+        using ConstructorFn = ClassBase* (*)();
+
         template <ReflectiveClass Clazz>
         static Class& FromStaticClass()
         {
+            ConstructorFn constructor = nullptr;
+            if constexpr (std::is_default_constructible_v<Clazz> && !std::is_abstract_v<Clazz>)
+                constructor = []() -> ClassBase* { return new Clazz(); };
+
             static Class clazz(Clazz::Static::Id,
                                Clazz::Static::SuperId,
-                               Clazz::Static::Name);
+                               Clazz::Static::Name,
+                               sizeof(Clazz),
+                               constructor);
             return clazz;
         }
 
+        /**
+         * Default-construct a new instance of this class on the heap
+         * @return Pointer to the new instance, nullptr if the class isn't default constructible
+         */
+        [[nodiscard]] ClassBase* Construct() const
+        {
+            return m_Constructor ? m_Constructor() : nullptr;
+        }
+
         /**
          * Expose a field to reflection
          * @param field
@@ -411,9 +432,28 @@ namespace Exi::Reflect
         ClassId GetId() const { return m_Id; }
         ClassId GetSuperId() const { return m_SuperId; }
         const char* GetName() const { return m_Name; }
+        std::size_t GetSize() const { return m_Size; }
+        bool IsConstructible() const { return m_Constructor != nullptr; }
+
+        /**
+         * Check whether this class is, or is derived from, another class.
+         * Both classes must be registered with the class registry.
+         * @param other
+         * @return True if this class is `other` or one of its subclasses
+         */
+        bool IsA(const Class& other) const
+        {
+            return (m_PreOrder >= other.m_PreOrder) && (m_PreOrder < other.m_PostOrder);
+        }
+
+        /** Position of this class in a depth-first walk of the class hierarchy */
+        std::uint32_t GetPreOrder() const { return m_PreOrder; }
+
+        /** One past the pre-order position of the last subclass of this class */
+        std::uint32_t GetPostOrder() const { return m_PostOrder; }
     private:
-        Class(ClassId Id, ClassId SuperId, const char* Name)
-                : m_Id(Id), m_SuperId(SuperId), m_Name(Name) { }
+        Class(ClassId Id, ClassId SuperId, const char* Name, std::size_t Size, ConstructorFn Constructor)
+                : m_Id(Id), m_SuperId(SuperId), m_Name(Name), m_Size(Size), m_Constructor(Constructor) { }
 
         const Field* GetInheritedField(FieldId id) const;
         const Method* GetInheritedMethod(MethodId id) const;
@@ -421,6 +461,10 @@ namespace Exi::Reflect
         ClassId m_Id;
         ClassId m_SuperId;
         const char* m_Name;
+        std::size_t m_Size;
+        ConstructorFn m_Constructor;
+        std::uint32_t m_PreOrder = 0;
+        std::uint32_t m_PostOrder = 0;
         std::unordered_map<FieldId, Field> m_FieldMap;
         std::unordered_map<MethodId, Method> m_MethodMap;
     };
@@ -3,7 +3,8 @@
 #include <Exile/Runtime/API.hpp>
 #include <Exile/Runtime/Path.hpp>
 #include <Exile/Runtime/Logger.hpp>
-#include <Exile/TL/LRUCache.hpp>
+#include <Exile/TL/ShardedCache.hpp>
+#include <Exile/TL/PoolAllocator.hpp>
 #include <cstddef>
 #include <concepts>
 #include <list>
@@ -12,6 +13,7 @@
 #include <atomic>
 #include <mutex>
 #include <shared_mutex>
+#include <span>
 #include <cassert>
 
 namespace Exi::Runtime
@@ -89,7 +91,13 @@ namespace Exi::Runtime
                     Path physicalPath,
                     int openMode);
 
-        bool ReopenAs(int openMode);
+        /**
+         * Reopen the file in another mode
+         * @param openMode
+         * @param shared True if other handles to the file are open, truncating is refused then
+         * @return True if the file was reopened
+         */
+        bool ReopenAs(int openMode, bool shared);
 
         /** Reference to parent filesystem */
         class Filesystem& m_Filesystem;
@@ -261,19 +269,22 @@ namespace Exi::Runtime
          * @return
          */
         VfsNode& MatchPath(const std::string& path,
-                           const std::vector<std::string_view>& fragments,
+                           std::span<const std::string_view> fragments,
                            std::size_t& indexOut);
 
+        /** Bytes of path text the translation cache may hold */
+        static constexpr std::size_t s_TranslationCacheBudget = 256 * 1024;
+
         Logger& m_Logger;
 
         std::shared_mutex m_VfsMutex;
         VfsNode m_Vfs;
 
-        std::mutex m_CacheMutex;
-        TL::LRUCache<std::string, Path> m_TranslationCache;
+        /** Weighted by the length of both paths, filled under a shared VFS lock so a mount can't race it */
+        TL::ShardedCache<std::string, Path> m_TranslationCache;
 
         std::shared_mutex m_FileMutex;
-        std::list<std::shared_ptr<FileControl>> m_Files;
+        std::list<std::shared_ptr<FileControl>, TL::PoolAllocator<std::shared_ptr<FileControl>>> m_Files;
     };
 
 }
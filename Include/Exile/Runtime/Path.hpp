@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Exile/Runtime/API.hpp>
+#include <Exile/TL/SmallVector.hpp>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Exi::Runtime
@@ -48,6 +50,30 @@ namespace Exi::Runtime
             return GetNextFragment(path, index);
         }
 
+        /** Fragment list with room for typical paths inline, so splitting them doesn't allocate */
+        using Fragments = TL::SmallVector<std::string_view, 16>;
+
+        /**
+         * Split a path into fragments, appending them to a caller-provided buffer.
+         * Only allocates if the path has more fragments than the buffer holds inline.
+         * @param path
+         * @param fragmentsOut
+         * @return Number of fragments in the path
+         */
+        static inline std::size_t SplitPath(std::string_view path, TL::SmallVectorBase<std::string_view>& fragmentsOut)
+        {
+            std::size_t index = 0;
+            auto fragment = GetNextFragment(path, index);
+
+            while (!fragment.empty())
+            {
+                fragmentsOut.push_back(fragment);
+                fragment = GetNextFragment(path, index);
+            }
+
+            return fragmentsOut.size();
+        }
+
         /**
          * Split a path into a vector of fragments
          * @param path
@@ -59,7 +85,6 @@ namespace Exi::Runtime
             std::size_t index = 0;
             auto fragment = GetNextFragment(path, index);
 
-            fragmentsOut.reserve(16);
             while (!fragment.empty())
             {
                 fragmentsOut.push_back(fragment);
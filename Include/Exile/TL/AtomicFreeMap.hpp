@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <Exile/TL/ByteUtils.hpp>
+#include <Exile/TL/ThreadIndex.hpp>
+
+namespace Exi::TL
+{
+
+    /**
+     * Lock-free bitset of free and used indices, safe to allocate from and free to on any thread.
+     *
+     * Allocate clears a bit with an atomic fetch-and and Free sets it with a fetch-or, so a
+     * thread only ever contends with others on the word it's touching. Each thread starts
+     * searching at its own hint, the word it last allocated from, which spreads threads
+     * across the map instead of having all of them fight over the lowest free word.
+     * Unlike FreeMap, allocated indices aren't necessarily the lowest free ones.
+     * @tparam N Number of bits
+     */
+    template <int N>
+    class AtomicFreeMap
+    {
+    public:
+        using Index   = std::size_t;
+        using Element = std::size_t;
+        static constexpr Index InvalidIndex = SIZE_MAX;
+        static constexpr int ElementBytes   = sizeof(Element);
+        static constexpr int ElementBits    = ElementBytes * 8;
+        static constexpr int Elements       = RoundUp(N, ElementBits) / ElementBits;
+
+        /** Threads with a higher ThreadIndex share hints with lower ones */
+        static constexpr std::size_t MaxThreads = 64;
+
+        static_assert(N >= 1, "Zero-bit AtomicFreeMap is invalid");
+
+        AtomicFreeMap()
+        {
+            for (int e = 0; e < Elements; e++)
+                m_Elements[e].store(ElementMask(e), std::memory_order_relaxed);
+
+            // Start threads evenly spread over the map
+            for (std::size_t t = 0; t < MaxThreads; t++)
+                m_Hints[t].Start.store(t * Elements / MaxThreads, std::memory_order_relaxed);
+        }
+
+        AtomicFreeMap(const AtomicFreeMap&) = delete;
+        AtomicFreeMap& operator=(const AtomicFreeMap&) = delete;
+
+        /**
+         * Allocate an index. On an almost full map, a bit freed in a word the search
+         * already passed may be missed.
+         * @return Free index if found, InvalidIndex otherwise
+         */
+        Index Allocate()
+        {
+            auto& hint = GetHint();
+            const Index start = hint.load(std::memory_order_relaxed);
+            for (Index n = 0; n < Elements; n++)
+            {
+                const Index e = Wrap(start + n);
+                auto& element = m_Elements[e];
+                Element word = element.load(std::memory_order_relaxed);
+                while (word)
+                {
+                    // Another thread may take the bit first, then retry with what it left
+                    const Element bit = Bit(FindFirstSet(word));
+                    const Element before = element.fetch_and(~bit, std::memory_order_acquire);
+                    if (before & bit)
+                    {
+                        if (e != start)
+                            hint.store(e, std::memory_order_relaxed);
+                        return e * ElementBits + FindFirstSet(bit);
+                    }
+                    word = before & ~bit;
+                }
+            }
+            return InvalidIndex;
+        }
+
+        /**
+         * Allocate a contiguous run of indices that fits in a single element
+         * @param count Number of indices, at most ElementBits
+         * @return First index of the run if found, InvalidIndex otherwise
+         */
+        Index AllocateRange(Index count)
+        {
+            if (count == 0 || count > ElementBits)
+                return InvalidIndex;
+            if (count == 1)
+                return Allocate();
+
+            auto& hint = GetHint();
+            const Index start = hint.load(std::memory_order_relaxed);
+            for (Index n = 0; n < Elements; n++)
+            {
+                const Index e = Wrap(start + n);
+                auto& element = m_Elements[e];
+                Element word = element.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    const int first = FindRun(word, count);
+                    if (first < 0)
+                        break;
+
+                    // Claim the whole run at once, or reload and look again if the word changed
+                    const Element mask = RunMask(first, count);
+                    if (element.compare_exchange_weak(word, word & ~mask, std::memory_order_acquire,
+                                                      std::memory_order_relaxed))
+                    {
+                        if (e != start)
+                            hint.store(e, std::memory_order_relaxed);
+                        return e * ElementBits + first;
+                    }
+                }
+            }
+            return InvalidIndex;
+        }
+
+        /**
+         * Free an index
+         * @param i
+         * @return True if the index was allocated, false if it was already free
+         */
+        bool Free(Index i)
+        {
+            const Element bit = Bit(i % ElementBits);
+            return !(m_Elements[i / ElementBits].fetch_or(bit, std::memory_order_release) & bit);
+        }
+
+        /**
+         * Free a run of indices returned by AllocateRange
+         * @param first
+         * @param count
+         */
+        void FreeRange(Index first, Index count)
+        {
+            const Element mask = RunMask(first % ElementBits, count);
+            m_Elements[first / ElementBits].fetch_or(mask, std::memory_order_release);
+        }
+
+        /**
+         * Check if an index is free
+         * @param i
+         * @return True if free
+         */
+        [[nodiscard]] bool IsFree(Index i) const
+        {
+            return m_Elements[i / ElementBits].load(std::memory_order_acquire) & Bit(i % ElementBits);
+        }
+
+        /**
+         * Count the free indices. There's no shared counter for threads to contend on,
+         * so this scans the whole map and is only a snapshot while other threads are active.
+         * @return Free count
+         */
+        [[nodiscard]] Index GetFreeCount() const
+        {
+            Index free = 0;
+            for (const auto& element : m_Elements)
+                free += PopCount(element.load(std::memory_order_relaxed));
+            return free;
+        }
+    private:
+        struct alignas(64) Hint
+        {
+            std::atomic<Index> Start;
+        };
+
+        static constexpr Element Bit(int bit) { return Element(1) << bit; }
+
+        static constexpr Index Wrap(Index e) { return e >= Elements ? e - Elements : e; }
+
+        /** Bits of element `e` that map to indices below N */
+        static constexpr Element ElementMask(int e)
+        {
+            if (e == Elements - 1 && N % ElementBits != 0)
+                return Bit(N % ElementBits) - 1;
+            return ~Element(0);
+        }
+
+        static constexpr Element RunMask(int first, Index count)
+        {
+            const Element run = count == ElementBits ? ~Element(0) : Bit(int(count)) - 1;
+            return run << first;
+        }
+
+        /**
+         * Find the lowest run of `count` set bits in a word
+         * @param word
+         * @param count
+         * @return Position of the run's first bit, -1 if there is none
+         */
+        static int FindRun(Element word, Index count)
+        {
+            // After this, bit i is set only if bits i..i+count-1 all were
+            for (Index have = 1; have < count; )
+            {
+                const Index shift = std::min(have, count - have);
+                word &= word >> shift;
+                have += shift;
+            }
+            return FindFirstSet(word);
+        }
+
+        std::atomic<Index>& GetHint()
+        {
+            return m_Hints[ThreadIndex::Get() % MaxThreads].Start;
+        }
+
+        std::array<std::atomic<Element>, Elements> m_Elements;
+        std::array<Hint, MaxThreads> m_Hints;
+    };
+
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <Exile/TL/ObjectPool.hpp>
+#include <Exile/TL/ThreadIndex.hpp>
+
+namespace Exi::TL
+{
+
+    /**
+     * Thread-safe object pool.
+     *
+     * Every thread owns a small cache of free object slots, so Get and Release only touch
+     * memory private to the calling thread. A cache that runs dry takes a full magazine of
+     * slots from the shared depot, and a cache that overflows hands a magazine back, so the
+     * depot lock is taken once every `MagazineSize` operations at most. Objects may be
+     * released on any thread, not just the one that got them.
+     * @tparam T
+     * @tparam MagazineSize Number of slots moved between a thread's cache and the depot at once
+     */
+    template <class T, std::size_t MagazineSize = 64>
+    class ConcurrentObjectPool
+    {
+    public:
+        using Object = T;
+        using Pool = ObjectPool<Object>;
+        using Magazine = std::array<Object*, MagazineSize>;
+
+        /** Threads with a higher ThreadIndex bypass the caches and lock the depot on every call */
+        static constexpr std::size_t MaxThreads = 64;
+
+        /**
+         * @param backing Where block memory comes from
+         */
+        explicit ConcurrentObjectPool(PoolBacking backing = PoolBacking::Heap) : m_Pool(backing) { }
+        ConcurrentObjectPool(const ConcurrentObjectPool&) = delete;
+        ConcurrentObjectPool& operator=(const ConcurrentObjectPool&) = delete;
+
+        /**
+         * Construct an object from the pool
+         * @tparam Args
+         * @param args
+         * @return Object pointer
+         */
+        template <class... Args>
+        Object* Get(Args&& ...args)
+        {
+            return new (Allocate()) Object (std::forward<Args>(args)...);
+        }
+
+        /**
+         * Release an object back to the pool, from any thread.
+         * Unlike ObjectPool, releasing an object twice isn't detected: cached slots still look allocated
+         * to the underlying pool. Debug builds assert on it when the slot is in the calling thread's
+         * cache or already back in the pool.
+         * @param ptr Object pointer, must have been allocated by an ObjectPool of the same type and not released yet
+         * @return True if the object was released, false if the pool doesn't own it
+         */
+        bool Release(Object* ptr)
+        {
+            if (!m_Pool.Owns(ptr))
+                return false;
+
+            assert(!IsReleased(ptr) && "Object released twice");
+            std::destroy_at(ptr);
+            Deallocate(ptr);
+            return true;
+        }
+
+        /**
+         * Take an unconstructed object slot from the pool
+         * @return Slot pointer
+         */
+        Object* Allocate()
+        {
+            Cache* cache = GetCache();
+            if (!cache)
+            {
+                std::unique_lock lock(m_DepotMutex);
+                return m_Pool.Allocate();
+            }
+
+            if (cache->Count == 0)
+                Refill(*cache);
+            return cache->Slots[--cache->Count];
+        }
+
+        /**
+         * Return an object slot to the pool without destroying it, from any thread.
+         * Returning a slot twice isn't checked here, Release checks in debug builds.
+         * @param ptr Slot pointer, must have been allocated by this pool and not returned yet
+         */
+        void Deallocate(Object* ptr)
+        {
+            Cache* cache = GetCache();
+            if (!cache)
+            {
+                std::unique_lock lock(m_DepotMutex);
+                m_Pool.Deallocate(ptr);
+                return;
+            }
+
+            if (cache->Count == cache->Slots.size())
+                Flush(*cache);
+            cache->Slots[cache->Count++] = ptr;
+        }
+
+        /**
+         * Get the number of full magazines waiting in the depot
+         * @return Magazine count
+         */
+        [[nodiscard]] std::size_t GetDepotSize() const
+        {
+            std::unique_lock lock(m_DepotMutex);
+            return m_Depot.size();
+        }
+
+        /**
+         * Get the number of blocks allocated by the underlying pool
+         * @return Block count
+         */
+        [[nodiscard]] std::size_t GetBlockCount() const
+        {
+            std::unique_lock lock(m_DepotMutex);
+            return m_Pool.GetBlockCount();
+        }
+
+        /**
+         * Get the pool's block, object and huge page usage.
+         * Slots cached by threads count as live, slots waiting in the depot don't.
+         * @return Pool statistics
+         */
+        [[nodiscard]] ObjectPoolStats GetStats() const
+        {
+            std::unique_lock lock(m_DepotMutex);
+            ObjectPoolStats stats = m_Pool.GetStats();
+            stats.LiveObjects -= m_Depot.size() * MagazineSize;
+            return stats;
+        }
+    private:
+        /** Holds up to two magazines, so alternating Get and Release at a boundary doesn't hit the depot */
+        struct alignas(64) Cache
+        {
+            std::array<Object*, MagazineSize * 2> Slots;
+            std::size_t Count = 0;
+        };
+
+        Cache* GetCache()
+        {
+            const std::size_t index = ThreadIndex::Get();
+            if (index >= MaxThreads)
+                return nullptr;
+
+            // Only the thread holding this index touches the slot, recycled indices inherit the cache
+            auto& cache = m_Caches[index];
+            if (!cache)
+                cache = std::make_unique<Cache>();
+            return cache.get();
+        }
+
+        /**
+         * Debug check for slots that were already returned. Slots cached by other threads or waiting
+         * in the depot aren't seen, checking them would need every thread's cache.
+         * @param ptr Slot pointer owned by the pool
+         * @return True if the slot is in the calling thread's cache or free in the underlying pool
+         */
+        bool IsReleased(const Object* ptr)
+        {
+            if (const Cache* cache = GetCache())
+            {
+                const auto cached = cache->Slots.begin() + cache->Count;
+                if (std::find(cache->Slots.begin(), cached, ptr) != cached)
+                    return true;
+            }
+
+            std::unique_lock lock(m_DepotMutex);
+            return !Pool::Block::FromPointer(ptr)->IsAllocated(ptr);
+        }
+
+        /**
+         * Fill an empty cache with one magazine, from the depot or fresh from the pool
+         * @param cache
+         */
+        void Refill(Cache& cache)
+        {
+            std::unique_lock lock(m_DepotMutex);
+            if (!m_Depot.empty())
+            {
+                const Magazine& magazine = m_Depot.back();
+                std::copy(magazine.begin(), magazine.end(), cache.Slots.begin());
+                m_Depot.pop_back();
+            }
+            else
+            {
+                for (std::size_t i = 0; i < MagazineSize; i++)
+                    cache.Slots[i] = m_Pool.Allocate();
+            }
+            cache.Count = MagazineSize;
+        }
+
+        /**
+         * Move the top magazine of a full cache to the depot
+         * @param cache
+         */
+        void Flush(Cache& cache)
+        {
+            cache.Count -= MagazineSize;
+
+            std::unique_lock lock(m_DepotMutex);
+            Magazine& magazine = m_Depot.emplace_back();
+            std::copy_n(cache.Slots.begin() + cache.Count, MagazineSize, magazine.begin());
+        }
+
+        std::array<std::unique_ptr<Cache>, MaxThreads> m_Caches;
+
+        mutable std::mutex m_DepotMutex;
+        std::vector<Magazine> m_Depot;
+        Pool m_Pool;
+    };
+
+}
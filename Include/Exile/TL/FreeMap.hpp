@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <Exile/TL/Range.hpp>
 #include <Exile/TL/ByteUtils.hpp>
 
@@ -9,7 +11,25 @@ namespace Exi::TL
 {
 
     /**
-     * Fixed-size bitset representing a region of free and used objects
+     * Upper bound of the size of a FreeMap
+     * @param bits Number of bits
+     * @return Size in bytes
+     */
+    static constexpr inline std::size_t FreeMapSize(std::size_t bits)
+    {
+        constexpr std::size_t elementBits = sizeof(std::size_t) * 8;
+        const std::size_t elements = RoundUp(bits, elementBits) / elementBits;
+        const std::size_t summary  = RoundUp(elements, elementBits) / elementBits;
+        const std::size_t top      = RoundUp(summary, elementBits) / elementBits;
+        return (elements + summary + top + 1) * sizeof(std::size_t);
+    }
+
+    /**
+     * Fixed-size bitset representing a region of free and used objects.
+     *
+     * Free bits are summarized twice: a summary bit per element with any free bit, and a top bit
+     * per summary element with any bit set. Allocating and freeing only touch one element per
+     * level, so they stay cheap even when a large map is almost full.
      * @tparam N Number of bits
      */
     template <int N>
@@ -18,31 +38,113 @@ namespace Exi::TL
     public:
         using Index   = std::size_t;
         using Element = std::size_t;
-        static constexpr Index InvalidIndex = SIZE_MAX;
-        static constexpr int ElementBytes   = sizeof(Element);
-        static constexpr int ElementBits    = ElementBytes * 8;
-        static constexpr int Elements       = RoundUp(N, ElementBits) / ElementBits;
+        static constexpr Index InvalidIndex  = SIZE_MAX;
+        static constexpr int ElementBytes    = sizeof(Element);
+        static constexpr int ElementBits     = ElementBytes * 8;
+        static constexpr int Elements        = RoundUp(N, ElementBits) / ElementBits;
+        static constexpr int SummaryElements = RoundUp(Elements, ElementBits) / ElementBits;
+        static constexpr int TopElements     = RoundUp(SummaryElements, ElementBits) / ElementBits;
 
-        static_assert(Elements >= 1, "Zero-bit FreeMap is invalid");
+        static_assert(N >= 1, "Zero-bit FreeMap is invalid");
 
-        FreeMap() { std::fill_n(m_Elements.begin(), Elements, InvalidIndex); }
+        FreeMap() { FreeAll(); }
 
         /**
          * Allocate an index
-         * @return Index if found, InvalidIndex otherwise
+         * @return Lowest free index if found, InvalidIndex otherwise
          */
         Index Allocate()
         {
-            for (int i = 0; i < Elements; i++)
+            // Small maps, like the ones in pool blocks, skip the levels they don't need
+            if constexpr (Elements == 1)
             {
-                Element e = m_Elements[i];
-                int bit   = FindFirstSet(e);
-
+                const int bit = FindFirstSet(m_Elements[0]);
                 if (bit < 0)
+                    return InvalidIndex;
+
+                m_Elements[0] &= ~Bit(bit);
+                if (!m_Elements[0])
+                    UpdateSummary(0);
+                --m_Free;
+                return bit;
+            }
+            else if constexpr (SummaryElements == 1)
+            {
+                if (!m_Summary[0])
+                    return InvalidIndex;
+                return AllocateFrom(FindFirstSet(m_Summary[0]));
+            }
+
+            for (int t = 0; t < TopElements; t++)
+            {
+                if (!m_Top[t])
+                    continue;
+
+                const Index s = t * ElementBits + FindFirstSet(m_Top[t]);
+                return AllocateFrom(s * ElementBits + FindFirstSet(m_Summary[s]));
+            }
+            return InvalidIndex;
+        }
+
+        /**
+         * Allocate a contiguous run of indices
+         * @param count Number of indices
+         * @return First index of the lowest free run that fits, InvalidIndex if there is none
+         */
+        Index AllocateRange(Index count)
+        {
+            if (count == 0 || count > m_Free)
+                return InvalidIndex;
+            if (count == 1)
+                return Allocate();
+
+            Index position = 0;
+            while (position < N)
+            {
+                // Skip to the first free bit at or after the position
+                const Index e = NextFreeElement(position / ElementBits);
+                if (e >= Elements)
+                    return InvalidIndex;
+
+                Element word = m_Elements[e];
+                if (e == position / ElementBits)
+                    word &= From(position % ElementBits);
+                if (!word)
+                {
+                    position = (e + 1) * ElementBits;
                     continue;
+                }
+
+                // Measure the run of free bits, stopping once it's long enough
+                const Index start = e * ElementBits + FindFirstSet(word);
+                Index end = start;
+                for (Index w = start / ElementBits; ; w++)
+                {
+                    if (w >= Elements)
+                    {
+                        end = N;
+                        break;
+                    }
 
-                m_Elements[i] &= ~(1ULL << bit);
-                return (i * ElementBits) + bit;
+                    Element used = ~m_Elements[w];
+                    if (w == start / ElementBits)
+                        used &= From(start % ElementBits);
+                    if (used)
+                    {
+                        end = w * ElementBits + FindFirstSet(used);
+                        break;
+                    }
+                    end = (w + 1) * ElementBits;
+                    if (end - start >= count)
+                        break;
+                }
+
+                if (end - start >= count)
+                {
+                    SetRange<false>(start, count);
+                    return start;
+                }
+                position = end;
             }
             return InvalidIndex;
         }
@@ -54,11 +156,170 @@ namespace Exi::TL
         void Free(Index i)
         {
             Element& e = m_Elements[i / ElementBits];
-            int bit = i % ElementBits;
-            e |= (1ULL << bit);
+            const Element bit = Bit(i % ElementBits);
+            if (e & bit)
+                return;
+
+            const bool wasEmpty = !e;
+            e |= bit;
+            if (wasEmpty)
+                UpdateSummary(i / ElementBits);
+            ++m_Free;
+        }
+
+        /**
+         * Free a contiguous run of indices
+         * @param first
+         * @param count
+         */
+        void FreeRange(Index first, Index count)
+        {
+            SetRange<true>(first, count);
+        }
+
+        /**
+         * Free every index
+         */
+        void FreeAll()
+        {
+            FillBits(m_Elements, N);
+            FillBits(m_Summary, Elements);
+            FillBits(m_Top, SummaryElements);
+            m_Free = N;
+        }
+
+        /**
+         * Check if an index is free
+         * @param i
+         * @return True if free
+         */
+        [[nodiscard]] bool IsFree(Index i) const
+        {
+            return m_Elements[i / ElementBits] & Bit(i % ElementBits);
         }
+
+        /**
+         * Get the number of free indices
+         * @return Free count
+         */
+        [[nodiscard]] Index GetFreeCount() const { return m_Free; }
     private:
+        static constexpr Element Bit(int bit) { return Element(1) << bit; }
+
+        /** Mask of every bit at or above `bit` */
+        static constexpr Element From(int bit) { return ~Element(0) << bit; }
+
+        /**
+         * Set the first `bits` bits of an array, clearing the rest
+         * @tparam Size
+         * @param elements
+         * @param bits
+         */
+        template <std::size_t Size>
+        static void FillBits(std::array<Element, Size>& elements, Index bits)
+        {
+            elements.fill(~Element(0));
+            if (bits % ElementBits != 0)
+                elements[Size - 1] = Bit(bits % ElementBits) - 1;
+        }
+
+        /**
+         * Allocate the lowest free bit of an element known to have one
+         * @param e Element index
+         * @return Index
+         */
+        Index AllocateFrom(Index e)
+        {
+            const int bit = FindFirstSet(m_Elements[e]);
+            m_Elements[e] &= ~Bit(bit);
+            if (!m_Elements[e])
+                UpdateSummary(e);
+            --m_Free;
+            return e * ElementBits + bit;
+        }
+
+        /**
+         * Refresh the summary and top bits covering an element after it became empty or non-empty
+         * @param e Element index
+         */
+        void UpdateSummary(Index e)
+        {
+            const Index s = e / ElementBits;
+            if (m_Elements[e])
+                m_Summary[s] |= Bit(e % ElementBits);
+            else
+                m_Summary[s] &= ~Bit(e % ElementBits);
+
+            // A single summary element is searched directly, the top level is never read
+            if constexpr (SummaryElements == 1)
+                return;
+
+            if (m_Summary[s])
+                m_Top[s / ElementBits] |= Bit(s % ElementBits);
+            else
+                m_Top[s / ElementBits] &= ~Bit(s % ElementBits);
+        }
+
+        /**
+         * Find the first element at or after `e` with any free bit
+         * @param e
+         * @return Element index, Elements if there is none
+         */
+        Index NextFreeElement(Index e) const
+        {
+            if (e >= Elements)
+                return Elements;
+
+            const Index s = e / ElementBits;
+            const Element summary = m_Summary[s] & From(e % ElementBits);
+            if (summary)
+                return s * ElementBits + FindFirstSet(summary);
+
+            const Index next = s + 1;
+            if (next >= SummaryElements)
+                return Elements;
+
+            Index t = next / ElementBits;
+            Element top = m_Top[t] & From(next % ElementBits);
+            while (!top)
+            {
+                if (++t >= TopElements)
+                    return Elements;
+                top = m_Top[t];
+            }
+
+            const Index found = t * ElementBits + FindFirstSet(top);
+            return found * ElementBits + FindFirstSet(m_Summary[found]);
+        }
+
+        /**
+         * Mark a run of indices free or used
+         * @tparam Free
+         * @param first
+         * @param count
+         */
+        template <bool Free>
+        void SetRange(Index first, Index count)
+        {
+            const Index last = first + count;
+            for (Index e = first / ElementBits; e * ElementBits < last; e++)
+            {
+                const int low = e == first / ElementBits ? first % ElementBits : 0;
+                const Index high = std::min<Index>(last - e * ElementBits, ElementBits);
+                const Element mask = From(low) & (high == ElementBits ? ~Element(0) : Bit(high) - 1);
+
+                const Element before = m_Elements[e];
+                m_Elements[e] = Free ? (before | mask) : (before & ~mask);
+                m_Free += PopCount(m_Elements[e]) - PopCount(before);
+                if (!before != !m_Elements[e])
+                    UpdateSummary(e);
+            }
+        }
+
         std::array<Element, Elements> m_Elements;
+        std::array<Element, SummaryElements> m_Summary;
+        std::array<Element, TopElements> m_Top;
+        Index m_Free;
     };
 
 }
@@ -1,12 +1,43 @@
 #pragma once
 
-#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <Exile/TL/PoolAllocator.hpp>
 
 namespace Exi::TL
 {
 
-    template <class K, class V>
+    /** Key hash used by the caches, std::hash unless a transparent one is specialized below */
+    template <class K>
+    struct CacheHash : std::hash<K> { };
+
+    /** Lets string-keyed caches be searched with a std::string_view or C string without a copy */
+    template <>
+    struct CacheHash<std::string>
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view key) const
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+
+    /**
+     * Fixed-capacity cache that evicts the least recently used entry.
+     *
+     * Entries live in a hash map and are threaded into a doubly-linked list from most to least
+     * recently used, so lookups, insertions and evictions are all O(1). The list links stay valid
+     * across rehashes because std::unordered_map never moves its nodes, whatever the allocator;
+     * the PoolAllocator only makes node allocation cheap.
+     * @tparam K Key type
+     * @tparam V Value type
+     * @tparam Hash Key hash, lookups by other types are allowed if it's transparent
+     */
+    template <class K, class V, class Hash = CacheHash<K>>
     class LRUCache
     {
     public:
@@ -15,45 +46,66 @@ namespace Exi::TL
 
         LRUCache(size_t capacity)
                 : m_Capacity(capacity)
-        { }
+        {
+            m_Cache.reserve(capacity);
+        }
 
-        /** Check if the cache contains a key */
-        bool Contains(const Key& key) const
+        LRUCache(const LRUCache&) = delete;
+        LRUCache& operator=(const LRUCache&) = delete;
+
+        /** Check if the cache contains a key, without marking it as used */
+        template <class KeyLike>
+        bool Contains(const KeyLike& key) const
+        {
+            return m_Cache.find(key) != m_Cache.end();
+        }
+
+        /**
+         * Look up a value and mark it as most recently used
+         * @param key
+         * @return Pointer to the value if cached, nullptr otherwise.
+         *         Valid until the entry is replaced or evicted.
+         */
+        template <class KeyLike>
+        const Value* TryGet(const KeyLike& key)
         {
-            return m_Cache.contains(key);
+            auto it = m_Cache.find(key);
+            if (it == m_Cache.end())
+                return nullptr;
+
+            MoveToFront(it->second);
+            return &it->second.Value;
         }
 
-        /** Get a value from the cache */
-        const Value& Get(const Key& key)
+        /** Get a value from the cache, throws std::out_of_range if it isn't cached */
+        template <class KeyLike>
+        const Value& Get(const KeyLike& key)
         {
-            auto it = std::find(m_Keys.cbegin(), m_Keys.cend(), key);
-            m_Keys.erase(it);
-            m_Keys.push_front(key);
-            return m_Cache.at(key);
+            if (const Value* value = TryGet(key))
+                return *value;
+            throw std::out_of_range("LRUCache::Get: key not cached");
         }
 
         /** Move a value into the cache */
         void Put(const Key& key, Value&& value)
         {
-            if (!Contains(key))
-            {
-                if (m_Keys.size() >= m_Capacity)
-                {
-                    m_Cache.erase(m_Keys.back());
-                    m_Keys.pop_back();
-                }
-            }
-            else
+            if (m_Capacity == 0)
+                return;
+
+            auto it = m_Cache.find(key);
+            if (it != m_Cache.end())
             {
-                auto it = std::find(m_Keys.cbegin(), m_Keys.cend(), key);
-                m_Keys.erase(it);
-                m_Cache.erase(key);
+                it->second.Value = std::move(value);
+                MoveToFront(it->second);
+                return;
             }
 
-            m_Keys.push_front(key);
+            if (m_Cache.size() >= m_Capacity)
+                EvictLast();
 
-            Key keyCopy = key;
-            m_Cache.emplace(std::move(keyCopy), std::move(value));
+            it = m_Cache.try_emplace(key, std::move(value)).first;
+            it->second.Key = &it->first;
+            PushFront(it->second);
         }
 
         /** Copy a value into the cache */
@@ -65,24 +117,68 @@ namespace Exi::TL
         /** Clear the cache */
         void Clear()
         {
-            m_Keys.clear();
             m_Cache.clear();
+            m_Head = m_Tail = nullptr;
         }
 
         /** Get current size of the cache in items */
-        [[nodiscard]] std::size_t Size() const { return m_Keys.size(); }
+        [[nodiscard]] std::size_t Size() const { return m_Cache.size(); }
 
         /** Get current estimated size of the cache in bytes */
         [[nodiscard]] std::size_t MemorySize() const
         {
             return sizeof(LRUCache) +
-                (m_Keys.size() * sizeof(Key)) +
-                (m_Cache.size() * sizeof(std::pair<Key, Value>));
+                (m_Cache.size() * sizeof(typename Map::value_type)) +
+                (m_Cache.bucket_count() * sizeof(void*));
         }
     private:
-        std::deque<Key> m_Keys;
-        std::unordered_map<Key, Value> m_Cache;
+        struct Entry
+        {
+            V Value;
+            const K* Key = nullptr;
+            Entry* Prev = nullptr;
+            Entry* Next = nullptr;
+        };
+
+        using Map = std::unordered_map<Key, Entry, Hash, std::equal_to<>,
+                                       PoolAllocator<std::pair<const Key, Entry>>>;
+
+        void PushFront(Entry& entry)
+        {
+            entry.Prev = nullptr;
+            entry.Next = m_Head;
+            if (m_Head)
+                m_Head->Prev = &entry;
+            else
+                m_Tail = &entry;
+            m_Head = &entry;
+        }
+
+        void Unlink(Entry& entry)
+        {
+            (entry.Prev ? entry.Prev->Next : m_Head) = entry.Next;
+            (entry.Next ? entry.Next->Prev : m_Tail) = entry.Prev;
+        }
+
+        void MoveToFront(Entry& entry)
+        {
+            if (&entry == m_Head)
+                return;
+            Unlink(entry);
+            PushFront(entry);
+        }
+
+        void EvictLast()
+        {
+            Entry& last = *m_Tail;
+            Unlink(last);
+            m_Cache.erase(*last.Key);
+        }
+
+        Map m_Cache;
+        Entry* m_Head = nullptr;
+        Entry* m_Tail = nullptr;
         std::size_t m_Capacity;
     };
 
-}
\ No newline at end of file
+}
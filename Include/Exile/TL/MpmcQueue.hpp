@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Exi::TL
+{
+
+    /**
+     * Bounded lock-free queue for any number of producer and consumer threads, after Dmitry
+     * Vyukov's design.
+     *
+     * Every slot has a sequence number that says whose turn it is: the producer of position `p`
+     * waits for it to read `p`, and the consumer waits for `p + 1`. Producers and consumers
+     * claim positions with a CAS on their own cache-line-padded counter, so the two sides only
+     * meet on the slots themselves. Batches claim a run of ready slots with a single CAS.
+     * @tparam T
+     */
+    template <class T>
+    class MpmcQueue
+    {
+    public:
+        using Value = T;
+
+        /**
+         * @param capacity Minimum number of items the queue holds, rounded up to a power of two
+         */
+        explicit MpmcQueue(std::size_t capacity)
+                : m_Mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+                  m_Slots(static_cast<Slot*>(::operator new((m_Mask + 1) * sizeof(Slot), std::align_val_t(alignof(Slot)))))
+        {
+            for (std::size_t i = 0; i <= m_Mask; i++)
+                new (&m_Slots[i]) Slot(i);
+        }
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        ~MpmcQueue()
+        {
+            const std::size_t enqueue = m_Enqueue.load(std::memory_order_acquire);
+            for (std::size_t position = m_Dequeue.load(std::memory_order_acquire); position != enqueue; position++)
+                std::destroy_at(Get(m_Slots[position & m_Mask]));
+
+            std::destroy_n(m_Slots, m_Mask + 1);
+            ::operator delete(m_Slots, std::align_val_t(alignof(Slot)));
+        }
+
+        /**
+         * Construct an item at the back of the queue
+         * @tparam Args
+         * @param args
+         * @return False if the queue is full
+         */
+        template <class... Args>
+        bool TryEmplace(Args&& ...args)
+        {
+            std::size_t position = m_Enqueue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot& slot = m_Slots[position & m_Mask];
+                const std::size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+                if (difference == 0)
+                {
+                    if (m_Enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        new (slot.Storage) Value (std::forward<Args>(args)...);
+                        slot.Sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // The slot still holds the item from one lap ago
+                    return false;
+                }
+                else
+                {
+                    position = m_Enqueue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool TryPush(const Value& value) { return TryEmplace(value); }
+        bool TryPush(Value&& value) { return TryEmplace(std::move(value)); }
+
+        /**
+         * Push up to `count` items into consecutive free slots
+         * @tparam It Input iterator, wrap it in std::move_iterator to move items in
+         * @param first
+         * @param count
+         * @return Number of items pushed, zero only if the queue is full
+         */
+        template <class It>
+        std::size_t TryPushBatch(It first, std::size_t count)
+        {
+            if (count == 0)
+                return 0;
+
+            std::size_t position = m_Enqueue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const auto difference = Difference(position, 0);
+                if (difference == 0)
+                {
+                    // Slots only become free for producers once their consumer is done with them
+                    const std::size_t claimed = CountReady(position, count, 0);
+                    if (m_Enqueue.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed))
+                    {
+                        for (std::size_t i = 0; i < claimed; i++, ++first)
+                        {
+                            Slot& slot = m_Slots[(position + i) & m_Mask];
+                            new (slot.Storage) Value (*first);
+                            slot.Sequence.store(position + i + 1, std::memory_order_release);
+                        }
+                        return claimed;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return 0;
+                }
+                else
+                {
+                    // Another producer claimed the slot since `position` was loaded
+                    position = m_Enqueue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * Take the item at the front of the queue
+         * @param value Receives the item
+         * @return False if the queue is empty
+         */
+        bool TryPop(Value& value)
+        {
+            std::size_t position = m_Dequeue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot& slot = m_Slots[position & m_Mask];
+                const std::size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                if (difference == 0)
+                {
+                    if (m_Dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        value = std::move(*Get(slot));
+                        Release(slot, position);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_Dequeue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * Take up to `count` items from consecutive filled slots
+         * @tparam It Output iterator
+         * @param out
+         * @param count
+         * @return Number of items taken, zero only if the queue is empty
+         */
+        template <class It>
+        std::size_t TryPopBatch(It out, std::size_t count)
+        {
+            if (count == 0)
+                return 0;
+
+            std::size_t position = m_Dequeue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const auto difference = Difference(position, 1);
+                if (difference == 0)
+                {
+                    const std::size_t claimed = CountReady(position, count, 1);
+                    if (m_Dequeue.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed))
+                    {
+                        for (std::size_t i = 0; i < claimed; i++, ++out)
+                        {
+                            Slot& slot = m_Slots[(position + i) & m_Mask];
+                            *out = std::move(*Get(slot));
+                            Release(slot, position + i);
+                        }
+                        return claimed;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return 0;
+                }
+                else
+                {
+                    position = m_Dequeue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /** Get the number of queued items, only a snapshot while other threads are active */
+        [[nodiscard]] std::size_t Size() const
+        {
+            const std::size_t dequeue = m_Dequeue.load(std::memory_order_acquire);
+            const std::size_t enqueue = m_Enqueue.load(std::memory_order_acquire);
+            return enqueue > dequeue ? enqueue - dequeue : 0;
+        }
+
+        [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+        [[nodiscard]] std::size_t GetCapacity() const { return m_Mask + 1; }
+    private:
+        struct Slot
+        {
+            explicit Slot(std::size_t sequence) : Sequence(sequence) { }
+
+            std::atomic<std::size_t> Sequence;
+            alignas(Value) std::byte Storage[sizeof(Value)];
+        };
+
+        /**
+         * Compare a slot's sequence with the one a side waits for
+         * @param position Position of the slot
+         * @param offset 0 for producers, 1 for consumers
+         * @return Zero if the slot is ready, negative if it is a lap behind (queue full for producers,
+         *         empty for consumers), positive if another thread already claimed it
+         */
+        std::ptrdiff_t Difference(std::size_t position, std::size_t offset) const
+        {
+            const std::size_t sequence = m_Slots[position & m_Mask].Sequence.load(std::memory_order_acquire);
+            return static_cast<std::ptrdiff_t>(sequence - (position + offset));
+        }
+
+        /**
+         * Count the slots from a ready position on that are ready for the same side
+         * @param position First position, already known to be ready
+         * @param count Most slots to count, at least one
+         * @param offset 0 for producers, 1 for consumers
+         * @return Number of consecutive ready slots, at least one
+         */
+        std::size_t CountReady(std::size_t position, std::size_t count, std::size_t offset) const
+        {
+            count = std::min(count, m_Mask + 1);
+            std::size_t ready = 1;
+            while (ready < count && Difference(position + ready, offset) == 0)
+                ready++;
+            return ready;
+        }
+
+        static Value* Get(Slot& slot) { return std::launder(reinterpret_cast<Value*>(slot.Storage)); }
+
+        /** Destroy the item in a consumed slot and hand the slot to the producer one lap ahead */
+        void Release(Slot& slot, std::size_t position)
+        {
+            std::destroy_at(Get(slot));
+            slot.Sequence.store(position + m_Mask + 1, std::memory_order_release);
+        }
+
+        const std::size_t m_Mask;
+        Slot* const m_Slots;
+        alignas(64) std::atomic<std::size_t> m_Enqueue = 0;
+        alignas(64) std::atomic<std::size_t> m_Dequeue = 0;
+    };
+
+}
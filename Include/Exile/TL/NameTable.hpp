@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Exi::TL
+{
+
+    /**
+     * Table of interned strings. Each distinct string is stored once and identified
+     * by a 32-bit ID, so objects holding names only pay for the ID and names compare
+     * by ID. Interned strings live as long as the table.
+     */
+    class NameTable
+    {
+    public:
+        using NameId = std::uint32_t;
+
+        /** ID of the empty string, always present */
+        static constexpr NameId EmptyName = 0;
+
+        /** Returned by Find for strings that were never interned */
+        static constexpr NameId InvalidName = UINT32_MAX;
+
+        NameTable()
+        {
+            Intern("");
+        }
+
+        NameTable(const NameTable&) = delete;
+        NameTable& operator=(const NameTable&) = delete;
+
+        /**
+         * Get the process-wide name table
+         * @return Global name table
+         */
+        static NameTable& GetGlobal()
+        {
+            static NameTable s_Global;
+            return s_Global;
+        }
+
+        /**
+         * Get the ID of a string, adding it to the table if necessary
+         * @param name
+         * @return Name ID
+         */
+        NameId Intern(std::string_view name)
+        {
+            {
+                std::shared_lock lock(m_Mutex);
+                auto it = m_Ids.find(name);
+                if (it != m_Ids.end())
+                    return it->second;
+            }
+
+            std::unique_lock lock(m_Mutex);
+            auto it = m_Ids.find(name);
+            if (it != m_Ids.end())
+                return it->second;
+
+            // Deque elements never move, so views of them stay valid as the table grows
+            const auto id = static_cast<NameId>(m_Strings.size());
+            const std::string& stored = m_Strings.emplace_back(name);
+            m_Ids.emplace(stored, id);
+
+            // Short strings are stored inline and already counted by sizeof(std::string)
+            const char* object = reinterpret_cast<const char*>(&stored);
+            if (stored.data() < object || stored.data() >= object + sizeof(stored))
+                m_Bytes += stored.capacity() + 1;
+            return id;
+        }
+
+        /**
+         * Get the ID of a string without interning it
+         * @param name
+         * @return Name ID if the string is in the table, InvalidName otherwise
+         */
+        [[nodiscard]] NameId Find(std::string_view name) const
+        {
+            std::shared_lock lock(m_Mutex);
+            auto it = m_Ids.find(name);
+            return it != m_Ids.end() ? it->second : InvalidName;
+        }
+
+        /**
+         * Get the string of a name ID
+         * @param id
+         * @return View of the interned string, valid for the lifetime of the table
+         */
+        [[nodiscard]] std::string_view Get(NameId id) const
+        {
+            std::shared_lock lock(m_Mutex);
+            return m_Strings[id];
+        }
+
+        [[nodiscard]] std::size_t GetCount() const
+        {
+            std::shared_lock lock(m_Mutex);
+            return m_Strings.size();
+        }
+
+        /**
+         * Estimate the memory held by the table, strings and index
+         * @return Memory usage in bytes
+         */
+        [[nodiscard]] std::size_t GetMemoryUsage() const
+        {
+            std::shared_lock lock(m_Mutex);
+            return m_Bytes + m_Strings.size() * sizeof(std::string) +
+                   m_Ids.bucket_count() * sizeof(void*) +
+                   m_Ids.size() * (sizeof(decltype(m_Ids)::value_type) + sizeof(void*) + sizeof(std::size_t));
+        }
+    private:
+        mutable std::shared_mutex m_Mutex;
+        std::deque<std::string> m_Strings;
+        std::unordered_map<std::string_view, NameId> m_Ids;
+        std::size_t m_Bytes = 0;
+    };
+
+}
@@ -1,140 +1,329 @@
 #pragma once
 
-#include <functional>
-#include <iterator>
+#include <bit>
 #include <concepts>
 #include <cstdint>
 #include <cstddef>
-#include <array>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
 
-#include <Exile/TL/ByteUtils.hpp>
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define EXI_NUMERICMAP_SSE2
+#endif
 
 namespace Exi::TL
 {
-    static constexpr inline std::uint32_t KeyReduce32(std::size_t key)
-    {
-        if constexpr (sizeof(std::size_t) == sizeof(std::uint32_t))
-            return static_cast<uint32_t>(key);
-        else
-        {
-            uint32_t high = (key >> 32ULL);
-            uint32_t low  = (key & 0xFFFFFFFFULL);
-            return high ^ low;
-        }
-    }
 
-    static constexpr inline std::uint8_t KeySplit4(std::uint8_t key)
-    {
-        uint8_t a = (key & 0xF0) >> 4;
-        uint8_t b = key & 0x0F;
-
-        uint8_t x = a ^ b;
-        uint8_t y = a & b;
-
-        return (y << 4) | x;
-    }
-
-    static constexpr inline std::uint32_t KeySplit16(std::uint32_t key)
+    /**
+     * Mix the bits of an integer key, so keys that only differ in a few bits
+     * still land in different groups and get different control bytes
+     * @param key
+     * @return Mixed key
+     */
+    static constexpr inline std::uint64_t KeyMix64(std::uint64_t key)
     {
-        uint8_t a = KeySplit4(key & 0xFF);
-        uint8_t b = KeySplit4((key >> 8) & 0xFF);
-        uint8_t c = KeySplit4((key >> 16) & 0xFF);
-        uint8_t d = KeySplit4((key >> 24) & 0xFF);
-
-        uint16_t x = (LowNibble(d) << 12)
-                     | (LowNibble(c) << 8)
-                     | (LowNibble(b) << 4)
-                     | LowNibble(a);
-        uint16_t y = (HighNibble(d) << 12)
-                     | (HighNibble(c) << 8)
-                     | (HighNibble(b) << 4)
-                     | HighNibble(a);
-
-        return ((y / 0xFFF) << 16) | (x / 0xFFF);
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 33;
+        key *= 0xC4CEB9FE1A85EC53ULL;
+        key ^= key >> 33;
+        return key;
     }
 
     /**
      * Numeric map, a multimap with a numeric key.
-     * Works best with keys that have high entropy.
+     *
+     * Keys live in a flat open-addressing table: every slot has a control byte holding
+     * 7 bits of the key's hash, and lookups compare 16 control bytes at a time with SSE2
+     * before touching any key. Values are stored in a contiguous node pool and chained
+     * per key in insertion order, so inserting never allocates per element. Erased values
+     * go on a free list and are reused by later insertions.
      * @tparam K
      * @tparam V
-     * @tparam B
      */
-    template <std::integral K, class V, int X = 32 / sizeof(void*), int Y = 32 / sizeof(void*)>
+    template <std::integral K, class V>
     class NumericMap
     {
     public:
         using Key   = K;
         using Value = V;
-        static constexpr int Rows    = X;
-        static constexpr int Columns = Y;
-        static constexpr int Buckets = Rows * Columns;
 
-        struct BucketNode
-        {
-            Key key;
-            Value value;
-            BucketNode* next;
+        /** Number of control bytes probed at once */
+        static constexpr std::size_t GroupSize = 16;
 
-            BucketNode() = default;
-            BucketNode(Key _key) : key(_key), next(nullptr) { }
+        /** Table slot of a key, heads the chain of its values */
+        struct KeySlot
+        {
+            Key           key;
+            std::uint32_t count;
+            std::uint32_t head;
+            std::uint32_t tail;
         };
 
-        struct KeyNode
+        /** Pooled value, linked to the next value with the same key */
+        struct ValueNode
         {
-            Key         key;
-            BucketNode* first;
-            KeyNode*    next;
-            std::size_t count;
+            Value         value;
+            std::uint32_t next;
         };
 
-        struct RowHead
+        /**
+         * Forward iterator over (key, value) pairs. Keys are visited in table order,
+         * the values of each key in insertion order.
+         * Erasing a value only invalidates iterators to that value, inserting invalidates all iterators.
+         * @tparam Const
+         */
+        template <bool Const>
+        class BasicIterator
         {
-            BucketNode* bucketNode = nullptr;
-            KeyNode*    keyNode    = nullptr;
+        public:
+            using MapType  = std::conditional_t<Const, const NumericMap, NumericMap>;
+            using ValueRef = std::conditional_t<Const, const Value&, Value&>;
+
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = std::pair<Key, Value>;
+            using reference         = std::pair<const Key&, ValueRef>;
+
+            BasicIterator() = default;
+
+            reference operator*() const
+            {
+                return { m_Map->m_Slots[m_Slot].key, m_Map->m_Nodes[m_Node].value };
+            }
+
+            BasicIterator& operator++()
+            {
+                m_Node = m_Map->m_Nodes[m_Node].next;
+                if (m_Node == NoNode)
+                    Seek(m_Slot + 1);
+                return *this;
+            }
+
+            BasicIterator operator++(int)
+            {
+                BasicIterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            /** Every value belongs to exactly one key, so the node alone identifies the position */
+            bool operator==(const BasicIterator& other) const { return m_Node == other.m_Node; }
+        private:
+            friend class NumericMap;
+
+            /**
+             * @param map
+             * @param slot First slot to visit
+             * @param end Slot after the last slot to visit
+             */
+            BasicIterator(MapType* map, std::size_t slot, std::size_t end)
+                : m_Map(map), m_End(end)
+            {
+                Seek(slot);
+            }
+
+            /**
+             * Move to the first value of the first occupied slot at or after `slot`
+             * @param slot
+             */
+            void Seek(std::size_t slot)
+            {
+                for (; slot < m_End; slot++)
+                {
+                    if ((m_Map->m_Control[slot] & Empty) == 0)
+                    {
+                        m_Slot = slot;
+                        m_Node = m_Map->m_Slots[slot].head;
+                        return;
+                    }
+                }
+                m_Node = NoNode;
+            }
+
+            MapType*      m_Map = nullptr;
+            std::size_t   m_Slot = 0;
+            std::size_t   m_End = 0;
+            std::uint32_t m_Node = NoNode;
         };
 
-        using RowType    = std::array<RowHead, Rows>;
-        using BucketPos  = uint32_t;
+        using Iterator      = BasicIterator<false>;
+        using ConstIterator = BasicIterator<true>;
+
+        /**
+         * Pair of iterators over the values of a single key
+         * @tparam It
+         */
+        template <class It>
+        struct Range
+        {
+            It first;
+            It last;
 
-        static constexpr int MaxMemory = (sizeof(RowType*) * Columns) + ((sizeof(RowHead) * Rows) * Columns);
+            It begin() const { return first; }
+            It end() const { return last; }
+            [[nodiscard]] bool empty() const { return first == last; }
+        };
 
-        NumericMap() : m_BucketColumns { nullptr } { }
+        NumericMap() = default;
         ~NumericMap()
         {
-            for (int c = 0; c < Columns; c++)
+            Deallocate();
+        }
+
+        NumericMap(const NumericMap&) = delete;
+        NumericMap& operator=(const NumericMap&) = delete;
+
+        NumericMap(NumericMap&& other) noexcept
+        {
+            Swap(other);
+        }
+
+        NumericMap& operator=(NumericMap&& other) noexcept
+        {
+            if (this != &other)
             {
-                auto* col = m_BucketColumns[c];
+                Deallocate();
+                m_Nodes.clear();
+                m_FreeNode = NoNode;
+                m_FreeNodes = 0;
+                Swap(other);
+            }
+            return *this;
+        }
 
-                if (col == nullptr)
-                    continue;
+        /**
+         * Emplace a key and value into the map. Values with the same key are kept in insertion order.
+         * @param key
+         * @param value
+         * @return Reference to emplaced value, valid until the next insertion
+         */
+        Value& Emplace(Key key, Value value)
+        {
+            KeySlot* slot = FindSlot(key);
+            if (slot == nullptr)
+                slot = InsertSlot(key);
+
+            std::uint32_t index = m_FreeNode;
+            if (index != NoNode)
+            {
+                m_FreeNode = m_Nodes[index].next;
+                m_FreeNodes--;
+                m_Nodes[index] = { std::move(value), NoNode };
+            }
+            else
+            {
+                index = static_cast<std::uint32_t>(m_Nodes.size());
+                m_Nodes.push_back({ std::move(value), NoNode });
+            }
+
+            if (slot->count == 0)
+                slot->head = index;
+            else
+                m_Nodes[slot->tail].next = index;
+            slot->tail = index;
+            slot->count++;
+
+            return m_Nodes[index].value;
+        }
+
+        /**
+         * Erase a key and all of its values
+         * @param key
+         * @return Number of values erased
+         */
+        std::size_t Erase(Key key)
+        {
+            KeySlot* slot = FindSlot(key);
+            if (!slot)
+                return 0;
+
+            const std::size_t count = slot->count;
+            for (std::uint32_t node = slot->head; node != NoNode; )
+            {
+                const std::uint32_t next = m_Nodes[node].next;
+                FreeNode(node);
+                node = next;
+            }
 
-                for (int r = 0; r < Rows; r++)
+            EraseSlot(slot);
+            return count;
+        }
+
+        /**
+         * Erase the first value of a key that compares equal to `value`.
+         * The key is erased with its last value.
+         * @param key
+         * @param value
+         * @return True if a value was erased
+         */
+        bool Erase(Key key, const Value& value)
+        {
+            KeySlot* slot = FindSlot(key);
+            if (!slot)
+                return false;
+
+            std::uint32_t previous = NoNode;
+            for (std::uint32_t node = slot->head; node != NoNode; node = m_Nodes[node].next)
+            {
+                if (!(m_Nodes[node].value == value))
                 {
-                    RowHead& row = (*col)[r];
-                    DestroyBucketList(row);
+                    previous = node;
+                    continue;
                 }
 
-                delete col;
+                const std::uint32_t next = m_Nodes[node].next;
+                if (previous == NoNode)
+                    slot->head = next;
+                else
+                    m_Nodes[previous].next = next;
+                if (slot->tail == node)
+                    slot->tail = previous;
+
+                FreeNode(node);
+                if (--slot->count == 0)
+                    EraseSlot(slot);
+                return true;
             }
+
+            return false;
         }
 
-        static constexpr inline BucketPos GetBucket(Key key)
+        Iterator begin() { return { this, 0, m_Capacity }; }
+        Iterator end() { return { }; }
+        ConstIterator begin() const { return { this, 0, m_Capacity }; }
+        ConstIterator end() const { return { }; }
+
+        /**
+         * Get the values of a key
+         * @param key
+         * @return Iterator range over (key, value) pairs, empty if the key isn't in the map
+         */
+        Range<Iterator> EqualRange(Key key)
         {
-            return KeySplit16(KeyReduce32(key));
+            const KeySlot* slot = FindSlot(key);
+            if (!slot)
+                return { };
+            const std::size_t index = slot - m_Slots;
+            return { Iterator(this, index, index + 1), Iterator() };
         }
 
         /**
-         * Emplace a key and value into the map
+         * Get the values of a key
          * @param key
-         * @param value
-         * @return Reference to emplaced value
+         * @return Iterator range over (key, value) pairs, empty if the key isn't in the map
          */
-        Value& Emplace(Key key, Value value)
+        Range<ConstIterator> EqualRange(Key key) const
         {
-            BucketNode* node = InsertEmpty(key);
-            node->value = value;
-            return node->value;
+            const KeySlot* slot = FindSlot(key);
+            if (!slot)
+                return { };
+            const std::size_t index = slot - m_Slots;
+            return { ConstIterator(this, index, index + 1), ConstIterator() };
         }
 
         /**
@@ -144,7 +333,7 @@ namespace Exi::TL
          */
         bool Contains(Key key) const
         {
-            return FindFirst(key) != nullptr;
+            return FindSlot(key) != nullptr;
         }
 
         /**
@@ -154,10 +343,8 @@ namespace Exi::TL
          */
         std::size_t Count(Key key) const
         {
-            auto keyNode = FindKey(key);
-            if (!keyNode)
-                return 0;
-            return keyNode->count;
+            const KeySlot* slot = FindSlot(key);
+            return slot ? slot->count : 0;
         }
 
         /**
@@ -169,18 +356,15 @@ namespace Exi::TL
          */
         std::size_t Find(Key key, Value* values, std::size_t maxValues) const
         {
-            auto keyNode = FindKey(key);
-            std::size_t i;
-            BucketNode* node;
-
-            if (!keyNode)
+            const KeySlot* slot = FindSlot(key);
+            if (!slot)
                 return 0;
 
-            node = keyNode->first;
-            for (i = 0; i < maxValues && i < keyNode->count; i++)
+            std::size_t i = 0;
+            for (std::uint32_t node = slot->head; i < maxValues && i < slot->count; i++)
             {
-                values[i] = node->value;
-                node = node->next;
+                values[i] = m_Nodes[node].value;
+                node = m_Nodes[node].next;
             }
 
             return i;
@@ -196,202 +380,363 @@ namespace Exi::TL
         std::size_t GetKeys(Key* keys, std::size_t maxKeys) const
         {
             std::size_t count = 0;
-            for (int c = 0; c < Columns; c++)
+            for (std::size_t group = 0; group < m_Capacity && count < maxKeys; group += GroupSize)
             {
-                auto* colPtr = m_BucketColumns[c];
-
-                if (!colPtr)
-                    continue;
-
-                for (int r = 0; r < Rows; r++)
+                std::uint32_t full = MatchFull(m_Control + group);
+                while (full && count < maxKeys)
                 {
-                    RowHead& row = (*colPtr)[r];
-                    KeyNode* keyNode = row.keyNode;
-                    while (keyNode != nullptr)
-                    {
-                        if (count < maxKeys)
-                            keys[count] = keyNode->key;
-                        keyNode = keyNode->next;
-                        ++count;
-                    }
+                    keys[count++] = m_Slots[group + std::countr_zero(full)].key;
+                    full &= full - 1;
                 }
             }
-            return count;
+            return m_Size;
         }
 
         /**
          * Get the number of keys in the map
          * @return Key count
          */
-        [[nodiscard]] std::size_t GetKeys() const { return GetKeys(nullptr, 0); }
+        [[nodiscard]] std::size_t GetKeys() const { return m_Size; }
 
         /**
-         * Expand the map to it's maximum capacity.
+         * Get the number of key slots in the table
+         * @return Key capacity
+         */
+        [[nodiscard]] std::size_t GetCapacity() const { return m_Capacity; }
+
+        /**
+         * Get the number of bytes allocated by the map, not counting the map object itself
+         * @return Heap memory usage in bytes
+         */
+        [[nodiscard]] std::size_t GetMemoryUsage() const
+        {
+            return m_Capacity * (1 + sizeof(KeySlot)) + m_Nodes.capacity() * sizeof(ValueNode);
+        }
+
+        /**
+         * Make room for a number of keys so inserting them doesn't rehash
+         * @param keys
+         */
+        void Reserve(std::size_t keys)
+        {
+            const std::size_t capacity = CapacityFor(keys);
+            if (capacity > m_Capacity)
+                Rehash(capacity);
+        }
+
+        /**
+         * Double the capacity of the map.
          * This can speed up insertions at the cost of memory.
          */
         void Expand()
         {
-            for (int i = 0; i < Columns; i++)
-            {
-                if (!m_BucketColumns[i])
-                    m_BucketColumns[i] = new RowType { };
-            }
+            Rehash(m_Capacity ? m_Capacity * 2 : GroupSize);
         }
 
         /**
-         * Search the map for empty bucket rows and prune them to save memory.
-         * @return Number of buckets freed
+         * Shrink the table to the smallest capacity that holds the current keys and release
+         * unused value storage. Values are compacted so each key's values are contiguous,
+         * which also invalidates all iterators.
+         * @return Number of key slots freed
          */
         int Contract()
         {
-            int freed = 0;
-            for (int i = 0; i < Columns; i++)
-            {
-                RowType* row = m_BucketColumns[i];
-                bool empty = true;
+            const std::size_t before = m_Capacity;
+            const std::size_t capacity = CapacityFor(m_Size);
+            if (capacity < m_Capacity)
+                Rehash(capacity);
+            CompactNodes();
+            return static_cast<int>(before - m_Capacity);
+        }
+    private:
+        static constexpr std::uint8_t  Empty   = 0x80;
+        static constexpr std::uint8_t  Deleted = 0xFE;
+        static constexpr std::uint32_t NoNode  = UINT32_MAX;
 
-                if (!row)
-                    continue;
+        static std::uint64_t Hash(Key key)
+        {
+            return KeyMix64(static_cast<std::uint64_t>(key));
+        }
 
-                for (int r = 0; r < Rows; r++)
-                {
-                    if (row->at(r).bucketNode != nullptr)
-                    {
-                        empty = false;
-                        break;
-                    }
-                }
+        /** Low 7 bits of the hash, stored in the control byte of a full slot */
+        static std::uint8_t H2(std::uint64_t hash) { return hash & 0x7F; }
 
-                if (empty)
-                {
-                    m_BucketColumns[i] = nullptr;
-                    delete row;
-                    freed += Rows;
-                }
-            }
-            return freed;
+        /** Remaining bits of the hash, pick the first group to probe */
+        static std::size_t H1(std::uint64_t hash) { return hash >> 7; }
+
+        /**
+         * Match a byte against a group of control bytes
+         * @param group
+         * @param byte
+         * @return Bit mask of matching positions
+         */
+        static std::uint32_t Match(const std::uint8_t* group, std::uint8_t byte)
+        {
+#ifdef EXI_NUMERICMAP_SSE2
+            const __m128i control = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(static_cast<char>(byte))));
+#else
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < GroupSize; i++)
+                mask |= static_cast<std::uint32_t>(group[i] == byte) << i;
+            return mask;
+#endif
         }
-    private:
+
         /**
-         * Insert an empty node for the given key
-         * @param key
-         * @return Pointer to empty node
+         * Match the empty and deleted slots of a group, both have their high bit set
+         * @param group
+         * @return Bit mask of free positions
          */
-        BucketNode* InsertEmpty(Key key)
+        static std::uint32_t MatchFree(const std::uint8_t* group)
+        {
+#ifdef EXI_NUMERICMAP_SSE2
+            return _mm_movemask_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(group)));
+#else
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < GroupSize; i++)
+                mask |= static_cast<std::uint32_t>(group[i] >> 7) << i;
+            return mask;
+#endif
+        }
+
+        static std::uint32_t MatchFull(const std::uint8_t* group)
+        {
+            return ~MatchFree(group) & 0xFFFF;
+        }
+
+        /**
+         * Smallest capacity that holds `keys` keys under the maximum load factor of 7/8
+         * @param keys
+         * @return Capacity, 0 for no keys
+         */
+        static std::size_t CapacityFor(std::size_t keys)
+        {
+            if (keys == 0)
+                return 0;
+            std::size_t capacity = GroupSize;
+            while (capacity * 7 / 8 < keys)
+                capacity *= 2;
+            return capacity;
+        }
+
+        KeySlot* FindSlot(Key key) const
         {
-            BucketPos    pos = GetBucket(key);
-            RowHead&     row = GetRow(pos)->at(LowWord(pos) % Rows);
-            BucketNode** bucket = &row.bucketNode;
-            BucketNode*  current = *bucket;
-            BucketNode*  node = new BucketNode(key);
-            bool newKey = (current == nullptr) || ((current->key != key) && (current->next == nullptr));
+            if (m_Size == 0)
+                return nullptr;
+
+            const std::uint64_t hash = Hash(key);
+            const std::uint8_t  h2 = H2(hash);
+            const std::size_t   groupMask = m_Capacity / GroupSize - 1;
 
-            // Check if we can push the node onto the front of the list
-            if (newKey)
+            // Triangular probing over groups visits every group of a power-of-two table
+            std::size_t group = H1(hash) & groupMask;
+            for (std::size_t step = 1; ; step++)
             {
-                PushHead(bucket, node);
-                PushKey(row, node, key);
-                return node;
+                const std::uint8_t* control = m_Control + group * GroupSize;
+                std::uint32_t match = Match(control, h2);
+                while (match)
+                {
+                    KeySlot* slot = m_Slots + group * GroupSize + std::countr_zero(match);
+                    if (slot->key == key)
+                        return slot;
+                    match &= match - 1;
+                }
+
+                if (Match(control, Empty))
+                    return nullptr;
+                group = (group + step) & groupMask;
             }
+        }
 
-            // Try to find the first value via the key list
-            auto* keyNode = FindKey(key);
-            if (keyNode != nullptr)
+        KeySlot* InsertSlot(Key key)
+        {
+            if (m_Growth == 0)
             {
-                // Append node after the key's first value
-                node->next = keyNode->first->next;
-                keyNode->first->next = node;
-                keyNode->count++;
-                return node;
+                // When erased slots rather than live keys used up the table, rehashing at the same
+                // capacity clears them. It must win back at least 1/16 of the table to amortize.
+                if (m_Capacity == 0)
+                    Rehash(GroupSize);
+                else if (m_Size + m_Capacity / 16 <= m_Capacity * 7 / 8)
+                    Rehash(m_Capacity);
+                else
+                    Rehash(m_Capacity * 2);
             }
 
-            // Insert value at the front of the list
-            PushHead(bucket, node);
-            PushKey(row, node, key);
-            return node;
+            const std::uint64_t hash = Hash(key);
+            KeySlot* slot = m_Slots + FindFree(hash);
+            *slot = { key, 0, NoNode, NoNode };
+            m_Size++;
+            return slot;
         }
 
-        void PushHead(BucketNode** bucket, BucketNode* node)
+        /**
+         * Claim the first free slot on the probe sequence of a hash
+         * @param hash
+         * @return Slot index
+         */
+        std::size_t FindFree(std::uint64_t hash)
         {
-            // Save next node pointer if it exists
-            node->next = *bucket;
-            *bucket = node;
+            const std::size_t groupMask = m_Capacity / GroupSize - 1;
+            std::size_t group = H1(hash) & groupMask;
+            for (std::size_t step = 1; ; step++)
+            {
+                std::uint8_t* control = m_Control + group * GroupSize;
+                const std::uint32_t free = MatchFree(control);
+                if (free)
+                {
+                    const std::size_t offset = std::countr_zero(free);
+                    if (control[offset] == Empty)
+                        m_Growth--;
+                    control[offset] = H2(hash);
+                    return group * GroupSize + offset;
+                }
+                group = (group + step) & groupMask;
+            }
         }
 
         /**
-         * Push a key onto the front of a row's key list
-         * @param head
-         * @param node
-         * @param key
+         * Release a key slot. If its group still has an empty slot, no probe ever continued past
+         * the group, so the slot can become empty again instead of being marked deleted.
+         * @param slot
          */
-        void PushKey(RowHead& head, BucketNode* node, Key key)
-        {
-            auto keyNode = new KeyNode { };
-            keyNode->key   = key;
-            keyNode->next  = head.keyNode;
-            keyNode->first = node;
-            keyNode->count = 1;
-            head.keyNode  = keyNode;
+        void EraseSlot(KeySlot* slot)
+        {
+            const std::size_t index = slot - m_Slots;
+            std::uint8_t* group = m_Control + (index & ~(GroupSize - 1));
+            if (Match(group, Empty))
+            {
+                m_Control[index] = Empty;
+                m_Growth++;
+            }
+            else
+            {
+                m_Control[index] = Deleted;
+            }
+            m_Size--;
+        }
+
+        void FreeNode(std::uint32_t node)
+        {
+            m_Nodes[node].next = m_FreeNode;
+            m_FreeNode = node;
+            m_FreeNodes++;
         }
 
         /**
-         * Find the node for a given key
-         * @param key
-         * @return Key node pointer if found, nullptr otherwise
+         * Rebuild the value pool without free nodes, storing each key's values next to each other
          */
-        KeyNode* FindKey(Key key) const
+        void CompactNodes()
         {
-            BucketPos pos = GetBucket(key);
-            RowType*  row = m_BucketColumns[HighWord(pos) % Columns];
+            if (m_FreeNodes == 0)
+            {
+                m_Nodes.shrink_to_fit();
+                return;
+            }
 
-            if (!row)
-                return nullptr;
+            std::vector<ValueNode> nodes;
+            nodes.reserve(m_Nodes.size() - m_FreeNodes);
+            for (std::size_t i = 0; i < m_Capacity; i++)
+            {
+                if (m_Control[i] & Empty)
+                    continue;
 
-            KeyNode* current = row->at(LowWord(pos) % Rows).keyNode;
+                KeySlot& slot = m_Slots[i];
+                const auto head = static_cast<std::uint32_t>(nodes.size());
+                for (std::uint32_t node = slot.head; node != NoNode; node = m_Nodes[node].next)
+                {
+                    const auto index = static_cast<std::uint32_t>(nodes.size());
+                    nodes.push_back({ std::move(m_Nodes[node].value), index + 1 });
+                }
+                nodes.back().next = NoNode;
+                slot.head = head;
+                slot.tail = static_cast<std::uint32_t>(nodes.size() - 1);
+            }
 
-            while (current != nullptr)
+            m_Nodes = std::move(nodes);
+            m_FreeNode = NoNode;
+            m_FreeNodes = 0;
+        }
+
+        void Rehash(std::size_t capacity)
+        {
+            std::uint8_t* oldControl = m_Control;
+            KeySlot* oldSlots = m_Slots;
+            const std::size_t oldCapacity = m_Capacity;
+
+            Allocate(capacity);
+            for (std::size_t group = 0; group < oldCapacity; group += GroupSize)
             {
-                if (current->key == key)
-                    return current;
-                current = current->next;
+                std::uint32_t full = MatchFull(oldControl + group);
+                while (full)
+                {
+                    const KeySlot& slot = oldSlots[group + std::countr_zero(full)];
+                    m_Slots[FindFree(Hash(slot.key))] = slot;
+                    full &= full - 1;
+                }
             }
 
-            return nullptr;
+            if (oldControl)
+                ::operator delete(oldControl, std::align_val_t(GroupSize));
         }
 
         /**
-         * Get the row pointer for a given bucket position
-         * @param pos
-         * @return
+         * Allocate an empty table, the control bytes and key slots share one block
+         * @param capacity
          */
-        RowType* GetRow(BucketPos pos)
+        void Allocate(std::size_t capacity)
         {
-            RowType* row = m_BucketColumns[HighWord(pos) % Columns];
-            if (!row)
-                row = m_BucketColumns[HighWord(pos) % Columns] = new RowType { };
-            return row;
+            // Reinserted keys claim their slots through FindFree(), which takes them off the growth budget
+            m_Capacity = capacity;
+            m_Growth = capacity * 7 / 8;
+            if (capacity == 0)
+            {
+                m_Control = nullptr;
+                m_Slots = nullptr;
+                return;
+            }
+
+            auto* block = static_cast<std::uint8_t*>(
+                ::operator new(capacity * (1 + sizeof(KeySlot)), std::align_val_t(GroupSize)));
+            std::memset(block, Empty, capacity);
+            m_Control = block;
+            m_Slots = reinterpret_cast<KeySlot*>(block + capacity);
         }
 
-        void DestroyBucketList(RowHead& row)
+        void Deallocate()
         {
-            BucketNode* node = row.bucketNode;
-            KeyNode* keyNode = row.keyNode;
-            while (node != nullptr)
-            {
-                BucketNode* lastNode = node;
-                node = node->next;
-                delete lastNode;
-            }
+            if (m_Control)
+                ::operator delete(m_Control, std::align_val_t(GroupSize));
+            m_Control = nullptr;
+            m_Slots = nullptr;
+            m_Capacity = m_Size = m_Growth = 0;
+        }
 
-            while (keyNode != nullptr)
-            {
-                KeyNode* lastNode = keyNode;
-                keyNode = keyNode->next;
-                delete lastNode;
-            }
+        void Swap(NumericMap& other)
+        {
+            std::swap(m_Control, other.m_Control);
+            std::swap(m_Slots, other.m_Slots);
+            std::swap(m_Capacity, other.m_Capacity);
+            std::swap(m_Size, other.m_Size);
+            std::swap(m_Growth, other.m_Growth);
+            std::swap(m_FreeNode, other.m_FreeNode);
+            std::swap(m_FreeNodes, other.m_FreeNodes);
+            m_Nodes.swap(other.m_Nodes);
         }
 
-        std::array<RowType*, Columns> m_BucketColumns;
+        std::uint8_t* m_Control = nullptr;
+        KeySlot*      m_Slots = nullptr;
+        std::size_t   m_Capacity = 0;
+        std::size_t   m_Size = 0;
+
+        /** Number of keys that can be inserted before the table must grow */
+        std::size_t   m_Growth = 0;
+
+        std::vector<ValueNode> m_Nodes;
+
+        /** Head of the list of erased value nodes, linked through `next` */
+        std::uint32_t m_FreeNode = NoNode;
+        std::size_t   m_FreeNodes = 0;
     };
 
 }
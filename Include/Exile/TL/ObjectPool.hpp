@@ -1,93 +1,238 @@
 #pragma once
 
-#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <vector>
-#include <bitset>
 #include <memory>
 #include <new>
+#include <Exile/TL/FreeMap.hpp>
+
+#ifdef __linux__
+    #include <sys/mman.h>
+#endif
 
 namespace Exi::TL
 {
+
+    /**
+     * Where an ObjectPool gets memory for its blocks
+     */
+    enum class PoolBacking
+    {
+        /** One aligned heap allocation per block */
+        Heap,
+
+        /**
+         * Blocks are carved out of 2 MiB regions mapped with transparent huge pages, cutting TLB misses
+         * for large pools. Falls back to the heap where huge pages aren't available.
+         */
+        HugePages
+    };
+
+    /**
+     * Snapshot of an ObjectPool's usage
+     */
+    struct ObjectPoolStats
+    {
+        std::size_t Blocks = 0;
+        std::size_t BlockBytes = 0;
+
+        /** Objects that can be allocated without adding a block, live or not */
+        std::size_t Capacity = 0;
+        std::size_t LiveObjects = 0;
+
+        /** Highest number of live objects at any one time */
+        std::size_t PeakLiveObjects = 0;
+
+        /** Bytes of huge page regions mapped by the pool, included in BlockBytes */
+        std::size_t HugePageBytes = 0;
+    };
+
+    /**
+     * Upper bound of the size of an ObjectBlock's header, including padding before its objects
+     * @param objects Object count
+     * @param objectAlign Object alignment
+     * @return Header size in bytes
+     */
+    static constexpr inline std::size_t ObjectBlockHeaderSize(std::size_t objects, std::size_t objectAlign)
+    {
+        return sizeof(void*) * 2 + FreeMapSize(objects) + objectAlign;
+    }
+
+    /**
+     * Smallest power of two, at least a page, that fits a block header and its objects
+     * @param objects Object count
+     * @param objectSize
+     * @param objectAlign
+     * @return Block alignment and size
+     */
+    static constexpr inline std::size_t ObjectBlockAlignment(std::size_t objects, std::size_t objectSize,
+                                                             std::size_t objectAlign)
+    {
+        return std::bit_ceil(std::max<std::size_t>(4096, ObjectBlockHeaderSize(objects, objectAlign) + objects * objectSize));
+    }
+
     /**
-     * Page-aligned block of memory to hold objects for an ObjectPool
+     * Number of objects that fit in a single page-sized block, at least one
+     * @param objectSize
+     * @param objectAlign
+     * @return Objects per block
+     */
+    static constexpr inline std::size_t ObjectBlockCapacity(std::size_t objectSize, std::size_t objectAlign)
+    {
+        std::size_t objects = 4096 / objectSize;
+        while (objects > 1 && ObjectBlockHeaderSize(objects, objectAlign) + objects * objectSize > 4096)
+            objects--;
+        return std::max<std::size_t>(objects, 1);
+    }
+
+    /**
+     * Block of memory to hold objects for an ObjectPool.
+     * Blocks are aligned to their own power-of-two size, so the block owning an object
+     * is found by masking the low bits of the object's address.
      * @tparam T       Object type
      * @tparam Objects Object count
      */
     template <class T, std::size_t Objects>
-    class alignas(4096) ObjectBlock
+    class alignas(ObjectBlockAlignment(Objects, sizeof(T), alignof(T))) ObjectBlock
     {
     public:
         using Object = T;
         static constexpr std::size_t ObjectCount = Objects;
         static constexpr std::size_t ObjectSize  = sizeof(Object);
         static constexpr std::size_t TotalSize   = ObjectCount * ObjectSize;
-        static constexpr std::size_t BlockSize   = sizeof(ObjectBlock);
+        static constexpr std::size_t BlockSize   = alignof(ObjectBlock);
+
+        static_assert(ObjectCount > 0, "ObjectBlock must hold at least one object");
+
+        using FreeMapType = FreeMap<static_cast<int>(ObjectCount)>;
+
+        /**
+         * @param owner Pool the block belongs to
+         */
+        explicit ObjectBlock(const void* owner) : m_Owner(owner)
+        {
+
+        }
+
+        /**
+         * Find the block an object was allocated from
+         * @param ptr Object pointer, must have been allocated by an ObjectBlock of this type
+         * @return Block pointer
+         */
+        static ObjectBlock* FromPointer(const Object* ptr)
+        {
+            return reinterpret_cast<ObjectBlock*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(BlockSize - 1));
+        }
 
         /**
          * Check if this block owns an object pointer
          * @param ptr
          * @return True if this block owns the pointer, false otherwise
          */
-        bool Owns(Object* ptr) const
+        bool Owns(const Object* ptr) const
+        {
+            auto val = reinterpret_cast<std::uintptr_t>(ptr);
+            auto base = reinterpret_cast<std::uintptr_t>(m_Storage);
+            return val >= base && val < base + TotalSize && (val - base) % ObjectSize == 0;
+        }
+
+        /**
+         * Take an unconstructed object slot from the block
+         * @return Slot pointer, null if the block is full
+         */
+        Object* Allocate()
         {
-            std::size_t val = reinterpret_cast<std::size_t>(ptr);
-            return val >= reinterpret_cast<std::size_t>(m_Storage.data())
-                && val <= reinterpret_cast<std::size_t>(m_Storage.data() + m_Storage.size());
+            const auto index = m_FreeMap.Allocate();
+            if (index == FreeMapType::InvalidIndex)
+                return nullptr;
+            return reinterpret_cast<Object*>(m_Storage + index * ObjectSize);
+        }
+
+        /**
+         * Return an object slot to the block without destroying it
+         * @param ptr Slot pointer
+         * @return True if the slot was returned, false if the block doesn't own it or it was already free
+         */
+        bool Deallocate(Object* ptr)
+        {
+            if (!Owns(ptr))
+                return false;
+
+            // Already free, released twice
+            const std::size_t index = (reinterpret_cast<std::uint8_t*>(ptr) - m_Storage) / ObjectSize;
+            if (m_FreeMap.IsFree(index))
+                return false;
+
+            m_FreeMap.Free(index);
+            return true;
         }
 
         /**
          * Construct an object in the block
          * @tparam Args
          * @param args
-         * @return Object pointer
+         * @return Object pointer, null if the block is full
          */
         template <class... Args>
         Object* Get(Args&& ...args)
         {
-            for (std::size_t i = 0; i < ObjectCount; i++)
-            {
-                if (!m_FreeMap.test(i))
-                {
-                    Object* ptr = reinterpret_cast<Object*>(m_Storage.data() + (i * sizeof(Object)));
-                    m_FreeMap.flip(i);
-                    --m_Free;
-                    return new (ptr) Object (std::forward<Args>(args)...);
-                }
-            }
-
-            return nullptr;
+            Object* ptr = Allocate();
+            if (ptr == nullptr)
+                return nullptr;
+            return new (ptr) Object (std::forward<Args>(args)...);
         }
 
         /**
          * Release an object back to the block
          * @param ptr Object pointer
-         * @return True if the object was successfully released, false otherwise
+         * @return True if the object was successfully released, false if the block doesn't own it or it was already released
          */
         bool Release(Object* ptr)
         {
-            if (!Owns(ptr))
+            if (!IsAllocated(ptr))
                 return false;
 
-            auto diff = reinterpret_cast<std::ptrdiff_t>(reinterpret_cast<uint8_t*>(ptr) - m_Storage.data());
-            auto index = diff / ObjectSize;
-
-            assert(m_FreeMap.test(index));
-
             std::destroy_at(ptr);
-            m_FreeMap.reset(index);
-            ++m_Free;
-            return true;
+            return Deallocate(ptr);
         }
 
-        [[nodiscard]] bool Empty() const { return m_Free == 0; }
+        /**
+         * Check if an object pointer belongs to the block and is currently allocated
+         * @param ptr
+         * @return True if allocated
+         */
+        [[nodiscard]] bool IsAllocated(const Object* ptr) const
+        {
+            if (!Owns(ptr))
+                return false;
+            const std::size_t index = (reinterpret_cast<const std::uint8_t*>(ptr) - m_Storage) / ObjectSize;
+            return !m_FreeMap.IsFree(index);
+        }
+
+        /**
+         * Check if the block has no free objects left
+         * @return True if full
+         */
+        [[nodiscard]] bool Empty() const { return m_FreeMap.GetFreeCount() == 0; }
+
+        [[nodiscard]] std::size_t GetFreeCount() const { return m_FreeMap.GetFreeCount(); }
+        [[nodiscard]] const void* GetOwner() const { return m_Owner; }
 
     private:
-        std::array<uint8_t, TotalSize> m_Storage;
-        std::bitset<ObjectCount> m_FreeMap;
-        std::size_t m_Free = ObjectCount;
+        template <class, std::size_t> friend class ObjectPool;
+
+        /** Back-pointer to the owning pool, checked on release */
+        const void* m_Owner;
+
+        /** Next block in the owning pool's list of blocks with free objects */
+        ObjectBlock* m_NextFree = nullptr;
+
+        FreeMapType m_FreeMap;
+        alignas(alignof(Object)) std::uint8_t m_Storage[TotalSize];
     };
 
     /**
@@ -95,7 +240,7 @@ namespace Exi::TL
      * @tparam T
      * @tparam PerBlock
      */
-    template <class T, std::size_t PerBlock = (4096 - 128) / sizeof(T)>
+    template <class T, std::size_t PerBlock = ObjectBlockCapacity(sizeof(T), alignof(T))>
     class alignas(64) ObjectPool
     {
     public:
@@ -105,6 +250,53 @@ namespace Exi::TL
         using Block = ObjectBlock<Object, ObjectsPerBlock>;
         using BlockPointer = Block*;
 
+        static_assert(sizeof(Block) == Block::BlockSize, "Objects must fit in a single aligned block");
+
+        /**
+         * Take an unconstructed object slot from the pool
+         * @return Slot pointer
+         */
+        Object* Allocate()
+        {
+            Block* block = m_FreeBlocks ? m_FreeBlocks : AddBlock();
+
+            Object* ptr = block->Allocate();
+            if (block->Empty())
+            {
+                // Full blocks leave the list until an object is released back to them
+                m_FreeBlocks = block->m_NextFree;
+                block->m_NextFree = nullptr;
+            }
+
+            m_PeakLive = std::max(m_PeakLive, ++m_Live);
+            return ptr;
+        }
+
+        /**
+         * Return an object slot to the pool without destroying it
+         * @param ptr Slot pointer, must have been allocated by an ObjectPool of the same type
+         * @return True if the slot was returned, false otherwise
+         */
+        bool Deallocate(Object* ptr)
+        {
+            if (!Owns(ptr))
+                return false;
+
+            Block* block = Block::FromPointer(ptr);
+            const bool wasFull = block->Empty();
+            if (!block->Deallocate(ptr))
+                return false;
+
+            if (wasFull)
+            {
+                block->m_NextFree = m_FreeBlocks;
+                m_FreeBlocks = block;
+            }
+
+            --m_Live;
+            return true;
+        }
+
         /**
          * Construct an object from the object pool
          * @tparam Args
@@ -114,54 +306,164 @@ namespace Exi::TL
         template <class... Args>
         Object* Get(Args&& ...args)
         {
-            /* Loop through blocks and try to get an object */
-            for (auto* block : m_Blocks)
-            {
-                if (block->Empty())
-                    continue;
-
-                Object* ptr = block->template Get(std::forward<Args>(args)...);
-                if (ptr != nullptr)
-                    return ptr;
-            }
-
-            /* No free objects, get a new block */
-            Block* block = AddBlock();
-            return block->template Get(std::forward<Args>(args)...);
+            return new (Allocate()) Object (std::forward<Args>(args)...);
         }
 
         /**
          * Release an object back to the object pool
-         * @param ptr Object pointer
+         * @param ptr Object pointer, must have been allocated by an ObjectPool of the same type
          * @return True if the object was successfully released, false otherwise
          */
         bool Release(Object* ptr)
         {
-            if (ptr == nullptr)
+            if (!Owns(ptr) || !Block::FromPointer(ptr)->IsAllocated(ptr))
                 return false;
 
-            for (auto& block : m_Blocks)
-            {
-                if (block->Release(ptr))
-                    return true;
-            }
+            std::destroy_at(ptr);
+            return Deallocate(ptr);
+        }
 
-            return false;
+        /**
+         * Check if an object pointer was allocated from a block of this pool.
+         * @param ptr Object pointer, must have been allocated by an ObjectPool of the same type
+         * @return True if the pool owns the pointer
+         */
+        [[nodiscard]] bool Owns(const Object* ptr) const
+        {
+            return ptr != nullptr && Block::FromPointer(ptr)->m_Owner == this;
         }
 
-        ObjectPool() { AddBlock(); }
+        /**
+         * Get the number of objects currently allocated from the pool
+         * @return Live object count
+         */
+        [[nodiscard]] std::size_t GetLiveCount() const { return m_Live; }
+
+        /**
+         * Get the number of blocks allocated by the pool
+         * @return Block count
+         */
+        [[nodiscard]] std::size_t GetBlockCount() const { return m_Blocks.size(); }
+
+        /**
+         * Get the pool's block, object and huge page usage
+         * @return Pool statistics
+         */
+        [[nodiscard]] ObjectPoolStats GetStats() const
+        {
+            ObjectPoolStats stats;
+            stats.Blocks = m_Blocks.size();
+            stats.BlockBytes = m_Blocks.size() * Block::BlockSize;
+            stats.Capacity = m_Blocks.size() * ObjectsPerBlock;
+            stats.LiveObjects = m_Live;
+            stats.PeakLiveObjects = m_PeakLive;
+            for (const auto& region : m_Regions)
+                stats.HugePageBytes += region.Size;
+            return stats;
+        }
+
+        /**
+         * @param backing Where block memory comes from
+         */
+        explicit ObjectPool(PoolBacking backing = PoolBacking::Heap) : m_Backing(backing) { AddBlock(); }
         ~ObjectPool()
         {
             for (auto* block : m_Blocks)
-                delete block;
+            {
+                if (IsMapped(block))
+                    std::destroy_at(block);
+                else
+                    delete block;
+            }
+
+#ifdef __linux__
+            for (const auto& region : m_Regions)
+                munmap(region.Base, region.Size);
+#endif
         }
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
     private:
+        /** Size of a huge page region, and of a huge page on x86-64 */
+        static constexpr std::size_t RegionSize = std::max<std::size_t>(2 * 1024 * 1024, Block::BlockSize);
+
+        struct Region
+        {
+            std::uint8_t* Base;
+            std::size_t Size;
+        };
+
         Block* AddBlock()
         {
-            return m_Blocks.emplace_back(new Block);
+            void* memory = m_Backing == PoolBacking::HugePages ? MapBlock() : nullptr;
+            Block* block = memory ? new (memory) Block(this) : new Block(this);
+
+            m_Blocks.push_back(block);
+            block->m_NextFree = m_FreeBlocks;
+            m_FreeBlocks = block;
+            return block;
         }
 
+        /**
+         * Take memory for a block from the current huge page region, mapping a new region if it's used up
+         * @return Block memory, null if no region could be mapped
+         */
+        void* MapBlock()
+        {
+#ifdef __linux__
+            if (m_RegionUsed == RegionSize || m_Regions.empty())
+            {
+                // Map twice the size and trim, so the region is aligned to the huge page size
+                void* mapping = mmap(nullptr, RegionSize * 2, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mapping == MAP_FAILED)
+                    return nullptr;
+
+                auto* raw = static_cast<std::uint8_t*>(mapping);
+                auto* base = reinterpret_cast<std::uint8_t*>(
+                    (reinterpret_cast<std::uintptr_t>(raw) + RegionSize - 1) & ~(RegionSize - 1));
+                if (base != raw)
+                    munmap(raw, base - raw);
+                munmap(base + RegionSize, raw + RegionSize * 2 - (base + RegionSize));
+
+                madvise(base, RegionSize, MADV_HUGEPAGE);
+                m_Regions.push_back({ base, RegionSize });
+                m_RegionUsed = 0;
+            }
+
+            void* memory = m_Regions.back().Base + m_RegionUsed;
+            m_RegionUsed += Block::BlockSize;
+            return memory;
+#else
+            return nullptr;
+#endif
+        }
+
+        bool IsMapped(const Block* block) const
+        {
+            auto* address = reinterpret_cast<const std::uint8_t*>(block);
+            for (const auto& region : m_Regions)
+            {
+                if (address >= region.Base && address < region.Base + region.Size)
+                    return true;
+            }
+            return false;
+        }
+
+        const PoolBacking m_Backing;
+
         std::vector<BlockPointer> m_Blocks;
+
+        /** Intrusive list of blocks with at least one free object */
+        Block* m_FreeBlocks = nullptr;
+
+        /** Huge page regions, blocks are handed out from the last one */
+        std::vector<Region> m_Regions;
+        std::size_t m_RegionUsed = 0;
+
+        std::size_t m_Live = 0;
+        std::size_t m_PeakLive = 0;
     };
 
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <Exile/TL/ConcurrentObjectPool.hpp>
+
+namespace Exi::TL
+{
+
+    /**
+     * Standard allocator that takes single objects from a process-wide ConcurrentObjectPool,
+     * meant for node-based containers like std::list and std::unordered_map.
+     * Array allocations, such as hash map bucket arrays, go to the heap.
+     *
+     * The allocator is stateless: every PoolAllocator<T> shares one pool, which is never
+     * destroyed so containers with static storage duration can outlive it safely.
+     * @tparam T
+     */
+    template <class T>
+    class PoolAllocator
+    {
+    public:
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+
+        template <class U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 1)
+                return reinterpret_cast<T*>(GetPool().Allocate());
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept
+        {
+            if (n == 1)
+                GetPool().Deallocate(reinterpret_cast<Slot*>(ptr));
+            else
+                ::operator delete(ptr, std::align_val_t(alignof(T)));
+        }
+
+        /**
+         * Get the usage of the pool shared by all PoolAllocator<T>
+         * @return Pool statistics
+         */
+        static ObjectPoolStats GetStats() { return GetPool().GetStats(); }
+
+        template <class U>
+        bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    private:
+        /** Raw storage for one T, so the pool never constructs or destroys anything */
+        struct alignas(alignof(T)) Slot
+        {
+            std::byte Storage[sizeof(T)];
+        };
+
+        static ConcurrentObjectPool<Slot>& GetPool()
+        {
+            static auto* pool = new ConcurrentObjectPool<Slot>();
+            return *pool;
+        }
+    };
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace Exi::TL
+{
+
+    /**
+     * Advance a SplitMix64 state and return the next output, used to expand one seed into
+     * the state of a larger generator
+     * @param state
+     * @return Next output
+     */
+    static constexpr inline std::uint64_t SplitMix64(std::uint64_t& state)
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * xoshiro256** pseudo-random generator: 256 bits of state, 64 bits per call, a handful of
+     * shifts and rotates per output. Fast enough to keep one per thread, but not suitable where
+     * outputs must be unpredictable to an attacker.
+     * Satisfies UniformRandomBitGenerator, so it works with the <random> distributions.
+     */
+    class Xoshiro256
+    {
+    public:
+        using result_type = std::uint64_t;
+
+        /**
+         * @param seed Expanded into the full state with SplitMix64
+         */
+        explicit Xoshiro256(std::uint64_t seed) { Seed(seed); }
+
+        /**
+         * Create a generator seeded from the operating system's entropy source
+         * @return Generator
+         */
+        static Xoshiro256 FromEntropy()
+        {
+            std::random_device device;
+            const std::uint64_t seed = (std::uint64_t(device()) << 32) ^ device();
+            return Xoshiro256(seed);
+        }
+
+        /**
+         * Reset the state, the same seed always gives the same sequence
+         * @param seed
+         */
+        void Seed(std::uint64_t seed)
+        {
+            for (auto& word : m_State)
+                word = SplitMix64(seed);
+        }
+
+        result_type operator()()
+        {
+            const std::uint64_t result = Rotate(m_State[1] * 5, 7) * 9;
+            const std::uint64_t t = m_State[1] << 17;
+
+            m_State[2] ^= m_State[0];
+            m_State[3] ^= m_State[1];
+            m_State[1] ^= m_State[2];
+            m_State[0] ^= m_State[3];
+            m_State[2] ^= t;
+            m_State[3] = Rotate(m_State[3], 45);
+            return result;
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    private:
+        static constexpr std::uint64_t Rotate(std::uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        std::array<std::uint64_t, 4> m_State;
+    };
+
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include <Exile/TL/LRUCache.hpp>
+
+namespace Exi::TL
+{
+
+    /**
+     * Thread-safe cache with a weight budget, split into independently locked shards by key hash.
+     *
+     * Eviction follows the CLOCK algorithm: a hit only sets the entry's reference bit under a
+     * shared lock, so any number of threads can read a shard at once. When a shard is over
+     * budget, its clock hand sweeps the entries, clearing reference bits and evicting the first
+     * entry that wasn't used since the hand last passed it.
+     *
+     * Every entry has a weight, such as its size in bytes, and each shard holds at most
+     * `budget / ShardCount` of it.
+     * @tparam K Key type
+     * @tparam V Value type, copied out on lookup
+     * @tparam Hash Key hash, lookups by other types are allowed if it's transparent
+     * @tparam ShardCount Number of shards, a power of two
+     */
+    template <class K, class V, class Hash = CacheHash<K>, std::size_t ShardCount = 16>
+    class ShardedCache
+    {
+    public:
+        using Key   = K;
+        using Value = V;
+
+        static_assert(std::has_single_bit(ShardCount), "Shard count must be a power of two");
+
+        /**
+         * @param budget Total weight of the entries the cache may hold
+         */
+        explicit ShardedCache(std::size_t budget)
+                : m_ShardBudget(std::max<std::size_t>(1, (budget + ShardCount - 1) / ShardCount))
+        { }
+
+        ShardedCache(const ShardedCache&) = delete;
+        ShardedCache& operator=(const ShardedCache&) = delete;
+
+        /** Check if the cache contains a key, without marking it as used */
+        template <class KeyLike>
+        bool Contains(const KeyLike& key) const
+        {
+            const Shard& shard = GetShard(key);
+            std::shared_lock lock(shard.Mutex);
+            return shard.Index.find(key) != shard.Index.end();
+        }
+
+        /**
+         * Look up a value and mark it as used
+         * @param key
+         * @param value Receives a copy of the value if cached
+         * @return True if the key was cached
+         */
+        template <class KeyLike>
+        bool TryGet(const KeyLike& key, Value& value)
+        {
+            Shard& shard = GetShard(key);
+            std::shared_lock lock(shard.Mutex);
+            auto it = shard.Index.find(key);
+            if (it == shard.Index.end())
+                return false;
+
+            Slot& slot = shard.Slots[it->second];
+            if (!slot.Referenced.load(std::memory_order_relaxed))
+                slot.Referenced.store(true, std::memory_order_relaxed);
+            value = slot.Value;
+            return true;
+        }
+
+        /**
+         * Insert or replace a value, evicting entries from its shard until it fits
+         * @param key
+         * @param value
+         * @param weight Cost of the entry counted against the budget
+         * @return False if the weight is larger than a whole shard's budget, in which case
+         *         nothing is cached
+         */
+        bool Put(const Key& key, Value value, std::size_t weight = 1)
+        {
+            if (weight > m_ShardBudget)
+                return false;
+
+            Shard& shard = GetShard(key);
+            std::unique_lock lock(shard.Mutex);
+            auto it = shard.Index.find(key);
+            if (it != shard.Index.end())
+            {
+                // Marked as used, so the sweep below evicts every other entry before this one
+                Slot& slot = shard.Slots[it->second];
+                shard.Weight += weight - slot.Weight;
+                slot.Value = std::move(value);
+                slot.Weight = weight;
+                slot.Referenced.store(true, std::memory_order_relaxed);
+                while (shard.Weight > m_ShardBudget)
+                    EvictOne(shard);
+                return true;
+            }
+
+            while (shard.Weight + weight > m_ShardBudget)
+                EvictOne(shard);
+
+            std::size_t index;
+            if (!shard.FreeSlots.empty())
+            {
+                index = shard.FreeSlots.back();
+                shard.FreeSlots.pop_back();
+                shard.Slots[index].Value = std::move(value);
+                shard.Slots[index].Weight = weight;
+            }
+            else
+            {
+                index = shard.Slots.size();
+                shard.Slots.emplace_back(std::move(value), weight);
+            }
+
+            it = shard.Index.emplace(key, index).first;
+            shard.Slots[index].Key = &it->first;
+            shard.Weight += weight;
+            return true;
+        }
+
+        /**
+         * Remove a key from the cache
+         * @param key
+         * @return True if the key was cached
+         */
+        template <class KeyLike>
+        bool Erase(const KeyLike& key)
+        {
+            Shard& shard = GetShard(key);
+            std::unique_lock lock(shard.Mutex);
+            auto it = shard.Index.find(key);
+            if (it == shard.Index.end())
+                return false;
+
+            Remove(shard, it->second);
+            return true;
+        }
+
+        /** Clear the cache */
+        void Clear()
+        {
+            for (Shard& shard : m_Shards)
+            {
+                std::unique_lock lock(shard.Mutex);
+                shard.Index.clear();
+                shard.Slots.clear();
+                shard.FreeSlots.clear();
+                shard.Hand = 0;
+                shard.Weight = 0;
+            }
+        }
+
+        /** Get current size of the cache in items */
+        [[nodiscard]] std::size_t Size() const
+        {
+            std::size_t size = 0;
+            for (const Shard& shard : m_Shards)
+            {
+                std::shared_lock lock(shard.Mutex);
+                size += shard.Index.size();
+            }
+            return size;
+        }
+
+        /** Get the total weight of the cached entries */
+        [[nodiscard]] std::size_t GetWeight() const
+        {
+            std::size_t weight = 0;
+            for (const Shard& shard : m_Shards)
+            {
+                std::shared_lock lock(shard.Mutex);
+                weight += shard.Weight;
+            }
+            return weight;
+        }
+
+        /** Get the weight each shard may hold */
+        [[nodiscard]] std::size_t GetShardBudget() const { return m_ShardBudget; }
+    private:
+        struct Slot
+        {
+            Slot(V&& value, std::size_t weight) : Value(std::move(value)), Weight(weight) { }
+
+            /** Points at the key in the shard's index, nullptr while the slot is free */
+            const K* Key = nullptr;
+            V Value;
+            std::size_t Weight;
+            std::atomic<bool> Referenced = false;
+        };
+
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex Mutex;
+            std::unordered_map<Key, std::size_t, Hash, std::equal_to<>> Index;
+            std::deque<Slot> Slots;
+            std::vector<std::size_t> FreeSlots;
+            std::size_t Hand = 0;
+            std::size_t Weight = 0;
+        };
+
+        template <class KeyLike>
+        Shard& GetShard(const KeyLike& key)
+        {
+            return m_Shards[ShardIndex(Hash{}(key))];
+        }
+
+        template <class KeyLike>
+        const Shard& GetShard(const KeyLike& key) const
+        {
+            return m_Shards[ShardIndex(Hash{}(key))];
+        }
+
+        /** Pick a shard from the high bits of the mixed hash, the shard's own map uses the low bits */
+        static std::size_t ShardIndex(std::size_t hash)
+        {
+            if constexpr (ShardCount == 1)
+            {
+                return 0;
+            }
+            else
+            {
+                constexpr int shift = 64 - std::countr_zero(ShardCount);
+                return (std::uint64_t(hash) * 0x9E3779B97F4A7C15ull) >> shift;
+            }
+        }
+
+        /**
+         * Advance a shard's clock hand until it evicts an entry. The shard must not be empty.
+         * @param shard
+         */
+        void EvictOne(Shard& shard)
+        {
+            for (;;)
+            {
+                if (shard.Hand >= shard.Slots.size())
+                    shard.Hand = 0;
+
+                const std::size_t index = shard.Hand++;
+                Slot& slot = shard.Slots[index];
+                if (!slot.Key)
+                    continue;
+
+                // Used since the last sweep, give it another round
+                if (slot.Referenced.load(std::memory_order_relaxed))
+                {
+                    slot.Referenced.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+
+                Remove(shard, index);
+                return;
+            }
+        }
+
+        void Remove(Shard& shard, std::size_t index)
+        {
+            Slot& slot = shard.Slots[index];
+            shard.Weight -= slot.Weight;
+            shard.Index.erase(shard.Index.find(*slot.Key));
+            slot.Key = nullptr;
+            slot.Referenced.store(false, std::memory_order_relaxed);
+            shard.FreeSlots.push_back(index);
+        }
+
+        std::array<Shard, ShardCount> m_Shards;
+        std::size_t m_ShardBudget;
+    };
+
+}
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Exi::TL
+{
+
+    /**
+     * Storage and interface of SmallVector without the inline capacity in its type, so functions
+     * can take a `SmallVectorBase<T>&` and let the caller pick how large a buffer to put on the
+     * stack. Instances only exist as part of a SmallVector.
+     *
+     * Member names follow std::vector so the two are interchangeable in existing code. Types that
+     * are trivially copyable are treated as trivially relocatable: growing reallocs the heap
+     * buffer in place and erasing memmoves the tail, without running any constructors.
+     * @tparam T Element type
+     */
+    template <class T>
+    class SmallVectorBase
+    {
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = T&;
+        using const_reference = const T&;
+        using pointer         = T*;
+        using const_pointer   = const T*;
+        using iterator        = T*;
+        using const_iterator  = const T*;
+
+        SmallVectorBase(const SmallVectorBase&) = delete;
+
+        SmallVectorBase& operator=(const SmallVectorBase& other)
+        {
+            if (this != &other)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+
+        SmallVectorBase& operator=(SmallVectorBase&& other)
+        {
+            if (this == &other)
+                return *this;
+
+            // A heap buffer can just change hands, an inline one has to be moved item by item
+            if (!other.IsInline())
+            {
+                DestroyAll();
+                FreeHeap();
+                m_Data = other.m_Data;
+                m_Size = other.m_Size;
+                m_Capacity = other.m_Capacity;
+                other.ResetToInline();
+                return *this;
+            }
+
+            clear();
+            reserve(other.size());
+            Relocate(other.begin(), other.size(), m_Data);
+            m_Size = other.m_Size;
+            other.m_Size = 0;
+            return *this;
+        }
+
+        [[nodiscard]] iterator       begin()       noexcept { return m_Data; }
+        [[nodiscard]] const_iterator begin() const noexcept { return m_Data; }
+        [[nodiscard]] iterator       end()         noexcept { return m_Data + m_Size; }
+        [[nodiscard]] const_iterator end()   const noexcept { return m_Data + m_Size; }
+
+        [[nodiscard]] T*       data()       noexcept { return m_Data; }
+        [[nodiscard]] const T* data() const noexcept { return m_Data; }
+
+        [[nodiscard]] T&       operator[](size_type index)       { assert(index < m_Size); return m_Data[index]; }
+        [[nodiscard]] const T& operator[](size_type index) const { assert(index < m_Size); return m_Data[index]; }
+
+        [[nodiscard]] T&       front()       { return (*this)[0]; }
+        [[nodiscard]] const T& front() const { return (*this)[0]; }
+        [[nodiscard]] T&       back()        { return (*this)[m_Size - 1]; }
+        [[nodiscard]] const T& back()  const { return (*this)[m_Size - 1]; }
+
+        [[nodiscard]] size_type size()     const noexcept { return m_Size; }
+        [[nodiscard]] size_type capacity() const noexcept { return m_Capacity; }
+        [[nodiscard]] bool      empty()    const noexcept { return m_Size == 0; }
+
+        /** Check if the items are still in the inline buffer, i.e. nothing was heap allocated */
+        [[nodiscard]] bool IsInline() const noexcept { return m_Data == GetInline(); }
+
+        /**
+         * Make room for at least `capacity` items
+         * @param capacity
+         */
+        void reserve(size_type capacity)
+        {
+            if (capacity > m_Capacity)
+                Grow(capacity);
+        }
+
+        template <class... Args>
+        T& emplace_back(Args&& ...args)
+        {
+            if (m_Size < m_Capacity) [[likely]]
+                return *new (m_Data + m_Size++) T (std::forward<Args>(args)...);
+
+            // Construct first, the arguments may refer to an item that's about to move
+            T value (std::forward<Args>(args)...);
+            Grow(m_Size + 1);
+            return *new (m_Data + m_Size++) T (std::move(value));
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        void pop_back()
+        {
+            assert(m_Size > 0);
+            std::destroy_at(m_Data + --m_Size);
+        }
+
+        /**
+         * Append a range of items
+         * @tparam It Forward iterator
+         * @param first
+         * @param last
+         */
+        template <std::forward_iterator It>
+        void append(It first, It last)
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            reserve(m_Size + count);
+            std::uninitialized_copy(first, last, m_Data + m_Size);
+            m_Size += count;
+        }
+
+        template <std::forward_iterator It>
+        void assign(It first, It last)
+        {
+            clear();
+            append(first, last);
+        }
+
+        void assign(std::initializer_list<T> values) { assign(values.begin(), values.end()); }
+
+        /**
+         * Erase a range of items, keeping the order of the rest
+         * @param first
+         * @param last
+         * @return Iterator to the item after the last erased one
+         */
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            auto* begin = const_cast<T*>(first);
+            const auto count = static_cast<size_type>(last - first);
+            if (count == 0)
+                return begin;
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memmove(static_cast<void*>(begin), last, (end() - last) * sizeof(T));
+            }
+            else
+            {
+                std::move(begin + count, end(), begin);
+                std::destroy(end() - count, end());
+            }
+            m_Size -= count;
+            return begin;
+        }
+
+        iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+        void resize(size_type size)
+        {
+            if (size < m_Size)
+            {
+                std::destroy(m_Data + size, end());
+            }
+            else
+            {
+                reserve(size);
+                std::uninitialized_value_construct(end(), m_Data + size);
+            }
+            m_Size = size;
+        }
+
+        void resize(size_type size, const T& value)
+        {
+            if (size < m_Size)
+            {
+                std::destroy(m_Data + size, end());
+            }
+            else
+            {
+                reserve(size);
+                std::uninitialized_fill(end(), m_Data + size, value);
+            }
+            m_Size = size;
+        }
+
+        /** Destroy every item, the capacity stays as it is */
+        void clear() noexcept
+        {
+            DestroyAll();
+            m_Size = 0;
+        }
+
+        friend bool operator==(const SmallVectorBase& a, const SmallVectorBase& b)
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+    protected:
+        explicit SmallVectorBase(std::size_t inlineCapacity)
+                : m_Data(GetInline()), m_Capacity(static_cast<std::uint32_t>(inlineCapacity))
+        { }
+
+        ~SmallVectorBase()
+        {
+            DestroyAll();
+            FreeHeap();
+        }
+
+        /**
+         * Address of the inline buffer, which SmallVector places directly after this class.
+         * Computing it instead of storing it keeps the header at 16 bytes.
+         */
+        [[nodiscard]] T* GetInline() const noexcept
+        {
+            constexpr std::size_t offset = (sizeof(SmallVectorBase) + alignof(T) - 1) & ~(alignof(T) - 1);
+            return reinterpret_cast<T*>(const_cast<std::byte*>(reinterpret_cast<const std::byte*>(this) + offset));
+        }
+    private:
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types aren't supported");
+
+        void Grow(size_type needed)
+        {
+            const size_type capacity = std::max<size_type>(needed, std::size_t(m_Capacity) * 2);
+            T* data;
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                // The allocator may be able to extend the block without copying anything
+                if (!IsInline())
+                {
+                    data = static_cast<T*>(std::realloc(m_Data, capacity * sizeof(T)));
+                    if (!data)
+                        throw std::bad_alloc();
+                    m_Data = data;
+                    m_Capacity = static_cast<std::uint32_t>(capacity);
+                    return;
+                }
+            }
+
+            data = static_cast<T*>(std::malloc(capacity * sizeof(T)));
+            if (!data)
+                throw std::bad_alloc();
+            Relocate(m_Data, m_Size, data);
+            FreeHeap();
+            m_Data = data;
+            m_Capacity = static_cast<std::uint32_t>(capacity);
+        }
+
+        /** Move items into uninitialized memory and end the lifetime of the originals */
+        static void Relocate(T* from, size_type count, T* to)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                if (count > 0)
+                    std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+            }
+            else
+            {
+                std::uninitialized_move_n(from, count, to);
+                std::destroy_n(from, count);
+            }
+        }
+
+        void DestroyAll() noexcept
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                std::destroy_n(m_Data, m_Size);
+        }
+
+        void FreeHeap() noexcept
+        {
+            if (!IsInline())
+                std::free(m_Data);
+        }
+
+        /**
+         * Point back at the inline buffer after the heap buffer was taken by another vector.
+         * The base doesn't know N, so the capacity drops to zero and the next push allocates,
+         * unless a SmallVector moved from as itself restores it.
+         */
+        void ResetToInline() noexcept
+        {
+            m_Data = GetInline();
+            m_Size = 0;
+            m_Capacity = 0;
+        }
+
+        template <class, std::size_t>
+        friend class SmallVector;
+
+        T* m_Data;
+        std::uint32_t m_Size = 0;
+        std::uint32_t m_Capacity;
+    };
+
+    /**
+     * Vector that keeps up to N items inline and only heap allocates once it grows past that.
+     * Meant for containers that are usually tiny; pass it around as SmallVectorBase<T>& where
+     * N shouldn't be part of the interface.
+     * @tparam T Element type
+     * @tparam N Number of items stored inline
+     */
+    template <class T, std::size_t N>
+    class SmallVector : public SmallVectorBase<T>
+    {
+    public:
+        using Base = SmallVectorBase<T>;
+
+        static_assert(N > 0, "SmallVector needs inline capacity, use std::vector otherwise");
+
+        SmallVector() : Base(N) { CheckLayout(); }
+
+        SmallVector(std::initializer_list<T> values) : SmallVector()
+        {
+            this->append(values.begin(), values.end());
+        }
+
+        template <std::forward_iterator It>
+        SmallVector(It first, It last) : SmallVector()
+        {
+            this->append(first, last);
+        }
+
+        SmallVector(const SmallVector& other) : SmallVector()
+        {
+            this->append(other.begin(), other.end());
+        }
+
+        SmallVector(const Base& other) : SmallVector()
+        {
+            this->append(other.begin(), other.end());
+        }
+
+        SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVector()
+        {
+            Base::operator=(std::move(other));
+            other.RestoreInline();
+        }
+
+        SmallVector(Base&& other) : SmallVector()
+        {
+            Base::operator=(std::move(other));
+        }
+
+        SmallVector& operator=(const SmallVector& other)
+        {
+            Base::operator=(other);
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& other)
+        {
+            Base::operator=(std::move(other));
+            other.RestoreInline();
+            return *this;
+        }
+
+        SmallVector& operator=(std::initializer_list<T> values)
+        {
+            this->assign(values);
+            return *this;
+        }
+
+    private:
+        /** Give a vector whose heap buffer was moved out its inline capacity back */
+        void RestoreInline() noexcept
+        {
+            if (this->IsInline())
+                this->m_Capacity = N;
+        }
+
+        void CheckLayout() const
+        {
+            assert(this->GetInline() == reinterpret_cast<const T*>(m_Inline));
+        }
+
+        alignas(T) std::byte m_Inline[N * sizeof(T)];
+    };
+
+}
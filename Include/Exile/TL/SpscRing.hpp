@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Exi::TL
+{
+
+    /**
+     * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+     *
+     * The producer only writes the tail and the consumer only writes the head, each on its own
+     * cache line. Both sides keep a private copy of the other's index and only reload the shared
+     * one when the copy says the ring is full or empty, so in steady state neither side touches
+     * the other's cache line at all.
+     * @tparam T
+     */
+    template <class T>
+    class SpscRing
+    {
+    public:
+        using Value = T;
+
+        /**
+         * @param capacity Minimum number of items the ring holds, rounded up to a power of two
+         */
+        explicit SpscRing(std::size_t capacity)
+                : m_Mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+                  m_Slots(static_cast<Slot*>(::operator new((m_Mask + 1) * sizeof(Slot), std::align_val_t(alignof(Slot)))))
+        { }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        ~SpscRing()
+        {
+            for (std::size_t i = m_Head.Index.load(); i != m_Tail.Index.load(); i++)
+                std::destroy_at(Get(i));
+            ::operator delete(m_Slots, std::align_val_t(alignof(Slot)));
+        }
+
+        /**
+         * Construct an item at the back of the ring, producer only
+         * @tparam Args
+         * @param args
+         * @return False if the ring is full
+         */
+        template <class... Args>
+        bool TryEmplace(Args&& ...args)
+        {
+            const std::size_t tail = m_Tail.Index.load(std::memory_order_relaxed);
+            if (tail - m_Tail.Cached > m_Mask)
+            {
+                m_Tail.Cached = m_Head.Index.load(std::memory_order_acquire);
+                if (tail - m_Tail.Cached > m_Mask)
+                    return false;
+            }
+
+            new (Get(tail)) Value (std::forward<Args>(args)...);
+            m_Tail.Index.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPush(const Value& value) { return TryEmplace(value); }
+        bool TryPush(Value&& value) { return TryEmplace(std::move(value)); }
+
+        /**
+         * Push as many items as fit, publishing them all at once, producer only
+         * @tparam It Input iterator, wrap it in std::move_iterator to move items in
+         * @param first
+         * @param count
+         * @return Number of items pushed
+         */
+        template <class It>
+        std::size_t TryPushBatch(It first, std::size_t count)
+        {
+            const std::size_t tail = m_Tail.Index.load(std::memory_order_relaxed);
+            if (m_Mask + 1 - (tail - m_Tail.Cached) < count)
+                m_Tail.Cached = m_Head.Index.load(std::memory_order_acquire);
+
+            count = std::min(count, m_Mask + 1 - (tail - m_Tail.Cached));
+            for (std::size_t i = 0; i < count; i++, ++first)
+                new (Get(tail + i)) Value (*first);
+            m_Tail.Index.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * Take the item at the front of the ring, consumer only
+         * @param value Receives the item
+         * @return False if the ring is empty
+         */
+        bool TryPop(Value& value)
+        {
+            const std::size_t head = m_Head.Index.load(std::memory_order_relaxed);
+            if (head == m_Head.Cached)
+            {
+                m_Head.Cached = m_Tail.Index.load(std::memory_order_acquire);
+                if (head == m_Head.Cached)
+                    return false;
+            }
+
+            value = std::move(*Get(head));
+            std::destroy_at(Get(head));
+            m_Head.Index.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Take up to `count` items, releasing their slots all at once, consumer only
+         * @tparam It Output iterator
+         * @param out
+         * @param count
+         * @return Number of items taken
+         */
+        template <class It>
+        std::size_t TryPopBatch(It out, std::size_t count)
+        {
+            const std::size_t head = m_Head.Index.load(std::memory_order_relaxed);
+            if (m_Head.Cached - head < count)
+                m_Head.Cached = m_Tail.Index.load(std::memory_order_acquire);
+
+            count = std::min(count, m_Head.Cached - head);
+            for (std::size_t i = 0; i < count; i++, ++out)
+            {
+                *out = std::move(*Get(head + i));
+                std::destroy_at(Get(head + i));
+            }
+            m_Head.Index.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        /** Get the number of queued items, only a snapshot while either side is active */
+        [[nodiscard]] std::size_t Size() const
+        {
+            return m_Tail.Index.load(std::memory_order_acquire) - m_Head.Index.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+        [[nodiscard]] std::size_t GetCapacity() const { return m_Mask + 1; }
+    private:
+        struct Slot
+        {
+            alignas(Value) std::byte Storage[sizeof(Value)];
+        };
+
+        /** An index owned by one side, and that side's copy of the other side's index */
+        struct alignas(64) Position
+        {
+            std::atomic<std::size_t> Index = 0;
+            std::size_t Cached = 0;
+        };
+
+        Value* Get(std::size_t index) { return std::launder(reinterpret_cast<Value*>(m_Slots[index & m_Mask].Storage)); }
+
+        const std::size_t m_Mask;
+        Slot* const m_Slots;
+        Position m_Head;
+        Position m_Tail;
+    };
+
+}
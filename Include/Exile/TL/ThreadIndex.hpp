@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace Exi::TL
+{
+
+    /**
+     * Dense per-thread index, suitable for indexing fixed-size per-thread arrays.
+     * Indices are handed out in order of first use and recycled when a thread exits,
+     * so the largest index in use stays close to the number of live threads.
+     */
+    class ThreadIndex
+    {
+    public:
+        /**
+         * Get the index of the calling thread
+         * @return Thread index
+         */
+        static std::size_t Get()
+        {
+            static thread_local ThreadIndex s_Local;
+            return s_Local.m_Index;
+        }
+
+        ThreadIndex(const ThreadIndex&) = delete;
+        ThreadIndex& operator=(const ThreadIndex&) = delete;
+    private:
+        ThreadIndex()
+        {
+            std::unique_lock lock(s_FreeMutex);
+            if (s_FreeIndices.empty())
+            {
+                m_Index = s_NextIndex++;
+            }
+            else
+            {
+                m_Index = s_FreeIndices.back();
+                s_FreeIndices.pop_back();
+            }
+        }
+
+        ~ThreadIndex()
+        {
+            std::unique_lock lock(s_FreeMutex);
+            s_FreeIndices.push_back(m_Index);
+        }
+
+        std::size_t m_Index;
+
+        static inline std::mutex s_FreeMutex;
+        static inline std::vector<std::size_t> s_FreeIndices;
+        static inline std::size_t s_NextIndex = 0;
+    };
+
+}
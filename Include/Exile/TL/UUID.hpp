@@ -1,8 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <compare>
 #include <cstdint>
-#include <random>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <Exile/TL/ByteUtils.hpp>
+#include <Exile/TL/Random.hpp>
+
+#if defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define EXI_UUID_SSSE3
+#endif
 
 namespace Exi::TL
 {
@@ -38,53 +50,349 @@ namespace Exi::TL
 
         bool operator!=(const UUID& uuid) const { return !(*this == uuid); }
 
+        /** Orders UUIDs like their string forms, so version 7 UUIDs sort by creation time */
+        std::strong_ordering operator<=>(const UUID& uuid) const
+        {
+            if (auto order = GetHigh() <=> uuid.GetHigh(); order != 0)
+                return order;
+            return GetLow() <=> uuid.GetLow();
+        }
+
+        /**
+         * Get the first 8 bytes of the string form as an integer
+         * @return Groups A, B and C
+         */
+        [[nodiscard]] uint64_t GetHigh() const
+        {
+            return (static_cast<uint64_t>(a) << 32) | (static_cast<uint64_t>(b) << 16) | c;
+        }
+
+        /**
+         * Get the last 8 bytes of the string form as an integer
+         * @return Both D groups
+         */
+        [[nodiscard]] uint64_t GetLow() const
+        {
+            return (d << 48) | (d >> 16);
+        }
+
+        /**
+         * Get the creation time of a version 7 UUID
+         * @return Milliseconds since the Unix epoch
+         */
+        [[nodiscard]] uint64_t GetTimestamp() const
+        {
+            return GetHigh() >> 16;
+        }
+
+        /** Length of the braced string form, without a terminator */
+        static constexpr std::size_t StringLength = 38;
+
+        /**
+         * Format as an uppercase braced string
+         * @param buffer Receives StringLength characters and a terminator
+         */
         void ToString(char buffer[39]) const
         {
-            snprintf(buffer, 39, "{%08X-%04X-%04X-%04llX-%012llX}", a, b, c, d & 0xFFFFUL, d >> 16UL);
+            Format(this, 1, buffer);
+            buffer[StringLength] = '\0';
         }
 
         std::string ToString() const
         {
             std::string s;
-            s.resize(39);
-            ToString(s.data());
+            s.resize(StringLength);
+            Format(this, 1, s.data());
             return s;
         }
 
+        /**
+         * Format UUIDs as braced strings laid end to end, without terminators
+         * @param uuids
+         * @param count
+         * @param buffer Receives count * StringLength characters
+         */
+        static void Format(const UUID* uuids, std::size_t count, char* buffer)
+        {
+            for (std::size_t i = 0; i < count; i++, buffer += StringLength)
+            {
+                buffer[0] = '{';
+                FormatHex(uuids[i], buffer + 1);
+                buffer[StringLength - 1] = '}';
+            }
+        }
+
+        /**
+         * Parse a UUID, with or without braces, in either case
+         * @param text
+         * @param uuid Receives the UUID if the text is valid
+         * @return True if the text is a valid UUID
+         */
+        static bool Parse(std::string_view text, UUID& uuid)
+        {
+            if (text.size() == StringLength)
+            {
+                if (text.front() != '{' || text.back() != '}')
+                    return false;
+                text = text.substr(1, StringLength - 2);
+            }
+            return text.size() == StringLength - 2 && ParseHex(text.data(), uuid);
+        }
+
+        /**
+         * Parse braced UUID strings laid end to end, as written by Format
+         * @param text count * StringLength characters
+         * @param count
+         * @param uuids Receives the UUIDs
+         * @return Number of UUIDs parsed before the first invalid one
+         */
+        static std::size_t Parse(const char* text, std::size_t count, UUID* uuids)
+        {
+            for (std::size_t i = 0; i < count; i++, text += StringLength)
+            {
+                if (!Parse(std::string_view(text, StringLength), uuids[i]))
+                    return i;
+            }
+            return count;
+        }
+
+        /**
+         * Generate a UUID with all 128 bits random
+         * @return UUID
+         */
         static UUID Random()
         {
-            static std::independent_bits_engine<std::default_random_engine, 8, uint8_t> s_Generator;
-            static bool s_Seeded = false;
+            auto& generator = GetGenerator();
+            const uint64_t high = generator();
+            const uint64_t low = generator();
+            return UUID(uint32_t(high >> 32), uint16_t(high >> 16), uint16_t(high), low);
+        }
+
+        /**
+         * Generate an RFC 4122 version 4 UUID: random apart from the version and variant bits
+         * @return UUID
+         */
+        static UUID V4()
+        {
+            UUID uuid = Random();
+            uuid.c = (uuid.c & 0x0FFF) | 0x4000;
+            uuid.d = (uuid.d & ~uint64_t(0xC000)) | 0x8000;
+            return uuid;
+        }
 
-            if (!s_Seeded)
+        /**
+         * Generate an RFC 9562 version 7 UUID: a 48-bit Unix millisecond timestamp, a 12-bit
+         * counter and 62 random bits. UUIDs generated on one thread are strictly increasing,
+         * and ones generated on different threads sort by the millisecond they were made in.
+         * Timestamps don't come from the seeded generator, so V7 UUIDs are never reproducible.
+         * @return UUID
+         */
+        static UUID V7()
+        {
+            struct Clock
             {
-                s_Generator.seed(__builtin_ia32_rdtsc());
-                s_Seeded = true;
+                uint64_t Millis = 0;
+                uint16_t Counter = 0;
+            };
+            static thread_local Clock s_Clock;
+
+            using namespace std::chrono;
+            const uint64_t now = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+            auto& generator = GetGenerator();
+
+            // Counters start at a random point in the lower half, leaving 2048 or more UUIDs per
+            // millisecond. Running out, or the clock going backwards, borrows from the next one.
+            if (now > s_Clock.Millis)
+            {
+                s_Clock.Millis = now;
+                s_Clock.Counter = generator() >> 53;
+            }
+            else if (++s_Clock.Counter > 0xFFF)
+            {
+                s_Clock.Millis++;
+                s_Clock.Counter = 0;
+            }
+
+            const uint64_t millis = s_Clock.Millis & 0xFFFFFFFFFFFF;
+            const uint64_t random = generator();
+            return UUID(uint32_t(millis >> 16), uint16_t(millis), uint16_t(0x7000 | s_Clock.Counter),
+                        (random & ~uint64_t(0xC000)) | 0x8000);
+        }
+
+        /**
+         * Reseed the calling thread's generator, making the sequence of UUIDs it generates
+         * reproducible. Every thread's generator is seeded from OS entropy by default.
+         * @param seed
+         */
+        static void Seed(uint64_t seed)
+        {
+            GetGenerator().Seed(seed);
+        }
+
+    private:
+        /**
+         * Write the 36 character unbraced form
+         * @param uuid
+         * @param out
+         */
+        static void FormatHex(const UUID& uuid, char* out)
+        {
+            // The string form is the big-endian bytes of the high and low halves
+            const uint64_t high = BYTESWAP64(uuid.GetHigh()), low = BYTESWAP64(uuid.GetLow());
+#ifdef EXI_UUID_SSSE3
+            // Look up both nibbles of every byte at once, then interleave them into 32 digits
+            const __m128i bytes = _mm_set_epi64x(static_cast<long long>(low), static_cast<long long>(high));
+            const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                                 '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i upper = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+            const __m128i lower = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibble));
+            const __m128i first = _mm_unpacklo_epi8(upper, lower);
+            const __m128i second = _mm_unpackhi_epi8(upper, lower);
+
+            // Spread the digits around the dashes, -128 lanes come out zero and take the dash
+            const __m128i head = _mm_or_si128(
+                _mm_shuffle_epi8(first, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, -128, 8, 9, 10, 11, -128, 12, 13)),
+                _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0));
+            const __m128i middle = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(first, _mm_setr_epi8(14, 15, -128, -128, -128, -128, -128, -128,
+                                                      -128, -128, -128, -128, -128, -128, -128, -128)),
+                _mm_shuffle_epi8(second, _mm_setr_epi8(-128, -128, -128, 0, 1, 2, 3, -128,
+                                                       4, 5, 6, 7, 8, 9, 10, 11))),
+                _mm_setr_epi8(0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0));
+            const int tail = _mm_cvtsi128_si32(_mm_srli_si128(second, 12));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), head);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), middle);
+            std::memcpy(out + 32, &tail, sizeof(tail));
+#else
+            constexpr char digits[] = "0123456789ABCDEF";
+            uint8_t bytes[16];
+            std::memcpy(bytes, &high, sizeof(high));
+            std::memcpy(bytes + 8, &low, sizeof(low));
+            for (int i = 0; i < 16; i++)
+            {
+                if (i == 4 || i == 6 || i == 8 || i == 10)
+                    *out++ = '-';
+                *out++ = digits[bytes[i] >> 4];
+                *out++ = digits[bytes[i] & 0x0F];
+            }
+#endif
+        }
+
+        /**
+         * Parse the 36 character unbraced form
+         * @param text
+         * @param uuid Receives the UUID if the text is valid
+         * @return True if the text is valid
+         */
+        static bool ParseHex(const char* text, UUID& uuid)
+        {
+            if (text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-')
+                return false;
+
+            uint64_t high, low;
+#ifdef EXI_UUID_SSSE3
+            // Gather the 32 digits from around the dashes
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 16));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 20));
+            const __m128i first = _mm_or_si128(
+                _mm_shuffle_epi8(a, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 14, 15, -128, -128)),
+                _mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
+                                                  -128, -128, -128, -128, -128, -128, 0, 1)));
+            const __m128i second = _mm_or_si128(
+                _mm_shuffle_epi8(b, _mm_setr_epi8(3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                  -128, -128, -128, -128)),
+                _mm_shuffle_epi8(c, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
+                                                  -128, -128, -128, -128, 12, 13, 14, 15)));
+
+            __m128i valid = _mm_set1_epi8(-1);
+            const __m128i values[2] = { HexValues(first, valid), HexValues(second, valid) };
+            if (_mm_movemask_epi8(valid) != 0xFFFF)
+                return false;
+
+            // Combine digit pairs into bytes: high digit * 16 + low digit
+            const __m128i weights = _mm_set1_epi16(0x0110);
+            const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(values[0], weights),
+                                                   _mm_maddubs_epi16(values[1], weights));
+            high = static_cast<uint64_t>(_mm_cvtsi128_si64(bytes));
+            low = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(bytes, bytes)));
+#else
+            uint8_t bytes[16];
+            for (int i = 0, position = 0; i < 16; i++, position += 2)
+            {
+                if (position == 8 || position == 13 || position == 18 || position == 23)
+                    position++;
+                const int upper = HexValue(text[position]), lower = HexValue(text[position + 1]);
+                if (upper < 0 || lower < 0)
+                    return false;
+                bytes[i] = static_cast<uint8_t>(upper << 4 | lower);
             }
+            std::memcpy(&high, bytes, sizeof(high));
+            std::memcpy(&low, bytes + 8, sizeof(low));
+#endif
+            high = BYTESWAP64(high);
+            low = BYTESWAP64(low);
+            uuid = UUID(uint32_t(high >> 32), uint16_t(high >> 16), uint16_t(high), (low << 16) | (low >> 48));
+            return true;
+        }
 
-            std::array<uint8_t, 16> bytes = { };
-            std::generate(bytes.begin(), bytes.end(), std::ref(s_Generator));
-            return UUID(bytes);
+#ifdef EXI_UUID_SSSE3
+        /**
+         * Convert 16 hex digits to their values
+         * @param chars
+         * @param valid Lanes that aren't hex digits are cleared
+         * @return Digit values
+         */
+        static __m128i HexValues(__m128i chars, __m128i& valid)
+        {
+            // Unsigned x <= limit is min(x, limit) == x
+            const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+            const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+            const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+            valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isLetter));
+            return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                                _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
         }
+#else
+        static int HexValue(char ch)
+        {
+            if (ch >= '0' && ch <= '9')
+                return ch - '0';
+            ch |= 0x20;
+            if (ch >= 'a' && ch <= 'f')
+                return ch - 'a' + 10;
+            return -1;
+        }
+#endif
 
+        /** One generator per thread, so generating never synchronizes */
+        static Xoshiro256& GetGenerator()
+        {
+            static thread_local Xoshiro256 s_Generator = Xoshiro256::FromEntropy();
+            return s_Generator;
+        }
     };
 
 }
 
 template <> struct std::hash<Exi::TL::UUID>
 {
-    std::size_t operator()(const Exi::TL::UUID& k) const
+    /**
+     * Folds the two 64-bit halves with a multiply, then finishes with a multiply-xorshift.
+     * Every step is invertible, so UUIDs sharing a prefix, like entity IDs, never collide.
+     */
+    std::size_t operator()(const Exi::TL::UUID& k) const noexcept
     {
-        std::size_t h = ~0;
+        std::uint64_t words[2];
+        std::memcpy(words, k.bytes.data(), sizeof(words));
 
-        for (int i = 0; i < 16; i++)
-        {
-            if constexpr(sizeof(std::size_t) == 8)
-            h <<= 4;
-            else
-                h <<= 2;
-            h ^= std::hash<uint8_t>()(k.bytes[i]);
-        }
-        return h;
+        std::uint64_t h = words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL);
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ULL;
+        h ^= h >> 32;
+        return static_cast<std::size_t>(h);
     }
 };
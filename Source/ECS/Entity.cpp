@@ -1,30 +1,97 @@
 #include <Exile/Reflect/Reflection.hpp>
 #include <Exile/ECS/Component.hpp>
 #include <Exile/ECS/Entity.hpp>
+#include <algorithm>
 
 namespace Exi::ECS
 {
     Entity::Entity(const std::string_view& name)
-            : m_RootComponent(nullptr), m_Name(name)
+            : m_RootComponent(nullptr), m_Name(TL::NameTable::GetGlobal().Intern(name))
     {
 
     }
 
     Entity::~Entity()
     {
-
+        // Components are owned by the entity they are attached to
+        ForEachComponent([](Reflect::ClassId, Component* component) {
+            delete component;
+        });
     }
 
     Component* Entity::GetComponent(Reflect::ClassId id) const
     {
         Component* component = nullptr;
-        m_ComponentMap.Find(id, &component, 1);
+        if (m_ComponentMap.Find(id, &component, 1) == 0 && !m_SharedComponents.empty())
+            return GetSharedComponent(id);
         return component;
     }
 
-    int Entity::GetComponentsOfType(Reflect::ClassId id, Component** components, std::size_t maxComponents) const
+    void Entity::AttachSharedComponent(Reflect::ClassId id, Component* component)
+    {
+        for (auto& pair : m_SharedComponents)
+        {
+            if (pair.first == id)
+            {
+                pair.second = component;
+                return;
+            }
+        }
+        m_SharedComponents.emplace_back(id, component);
+    }
+
+    bool Entity::DetachSharedComponent(Reflect::ClassId id)
+    {
+        auto it = std::find_if(m_SharedComponents.begin(), m_SharedComponents.end(),
+                               [id](const auto& pair) { return pair.first == id; });
+        if (it == m_SharedComponents.end())
+            return false;
+        m_SharedComponents.erase(it);
+        return true;
+    }
+
+    Component* Entity::GetSharedComponent(Reflect::ClassId id) const
+    {
+        for (const auto& pair : m_SharedComponents)
+        {
+            if (pair.first == id)
+                return pair.second;
+        }
+        return nullptr;
+    }
+
+    int Entity::GetComponentsOfType(Reflect::ClassId id, Component** components, std::size_t maxComponents,
+                                    bool includeDerived) const
     {
-        return m_ComponentMap.Find(id, components, maxComponents);
+        if (includeDerived)
+        {
+            auto classes = Reflect::ClassRegistry::GetInstance()->GetDerivedClasses(id);
+            if (!classes.empty())
+                return GetComponentsOfType(classes, components, maxComponents);
+        }
+        return GetComponentsOfType(std::span(&id, 1), components, maxComponents);
+    }
+
+    int Entity::GetComponentsOfType(std::span<const Reflect::ClassId> classes, Component** components,
+                                    std::size_t maxComponents) const
+    {
+        std::size_t count = 0;
+        for (Reflect::ClassId id : classes)
+        {
+            if (count >= maxComponents)
+                break;
+            count += m_ComponentMap.Find(id, components + count, maxComponents - count);
+        }
+
+        // Shared components follow the entity's own
+        for (const auto& [id, component] : m_SharedComponents)
+        {
+            if (count >= maxComponents)
+                break;
+            if (std::find(classes.begin(), classes.end(), id) != classes.end())
+                components[count++] = component;
+        }
+        return static_cast<int>(count);
     }
 
     void Entity::AttachComponent(Reflect::ClassId id, Component* component)
@@ -32,9 +99,29 @@ namespace Exi::ECS
         m_ComponentMap.Emplace(id, component)->OnAttached(*this);
     }
 
-    int Entity::GetComponentCount(Reflect::ClassId id) const
+    std::unique_ptr<Component> Entity::DetachComponent(Reflect::ClassId id, Component* component)
     {
-        return m_ComponentMap.Count(id);
+        if (!m_ComponentMap.Erase(id, component))
+            return nullptr;
+        return std::unique_ptr<Component>(component);
+    }
+
+    int Entity::GetComponentCount(Reflect::ClassId id, bool includeDerived) const
+    {
+        std::span<const Reflect::ClassId> classes(&id, 1);
+        if (includeDerived)
+        {
+            auto derived = Reflect::ClassRegistry::GetInstance()->GetDerivedClasses(id);
+            if (!derived.empty())
+                classes = derived;
+        }
+
+        int count = 0;
+        for (Reflect::ClassId match : classes)
+            count += m_ComponentMap.Count(match);
+        for (const auto& pair : m_SharedComponents)
+            count += std::find(classes.begin(), classes.end(), pair.first) != classes.end();
+        return count;
     }
 
-}
\ No newline at end of file
+}
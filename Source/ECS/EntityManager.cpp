@@ -1,11 +1,23 @@
 #include <Exile/ECS/EntityManager.hpp>
+#include <Exile/Runtime/Logger.hpp>
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
 
 namespace Exi::ECS
 {
 
-    EntityManager::EntityManager()
+    static std::uint64_t NextManagerSerial()
     {
+        static std::atomic_uint64_t s_NextSerial = 1;
+        return s_NextSerial++;
+    }
 
+    EntityManager::EntityManager()
+        : m_Serial(NextManagerSerial())
+    {
+        const auto prefix = TL::UUID::Random();
+        m_IdPrefix = (static_cast<std::uint64_t>(prefix.a) << 32) | (static_cast<std::uint64_t>(prefix.b) << 16) | prefix.c;
     }
 
     EntityManager::~EntityManager()
@@ -15,76 +27,460 @@ namespace Exi::ECS
 
     EntityManager::SystemId EntityManager::RegisterSystem(System* system)
     {
-        std::unique_lock lock(m_Mutex);
+        std::unique_lock lock(m_SystemMutex);
         SystemId id = m_Systems.size();
-        m_Systems.emplace_back(system);
 
-        if (m_Entities.size() > 0)
+        // New system needs to be notified of existing entities. Each shard's pending entities
+        // are taken in the same step, an entity added concurrently would otherwise reach the
+        // new system once from the walk and again from the next merge.
+        for (auto& shard : m_Shards)
         {
-            // New system needs to be notified of existing entities
-            for (auto& pair : m_Entities)
+            std::vector<Entity*> pending;
             {
-                Entity& e = *pair.second.get();
-                if (system->NotifyEntity(e))
-                    system->AddEntity(e);
+                std::unique_lock shardLock(shard.Mutex);
+                TakePending(shard, pending);
+                for (auto& pair : shard.Entities)
+                {
+                    Entity& e = *pair.second.get();
+                    if (system->NotifyEntity(e))
+                        system->AddEntity(e);
+                }
             }
+
+            // The new system isn't registered yet, so only the others see these here
+            NotifySystems(pending);
         }
 
+        m_Systems.emplace_back(system);
         return id;
     }
 
     void EntityManager::TickSystems(double deltaTime)
     {
-        std::shared_lock lock(m_Mutex);
+        std::unique_lock lock(m_SystemMutex);
+        MergePending();
+
         for (auto* system : m_Systems)
         {
             system->Tick(deltaTime);
         }
+
+        SwapEvents();
+
+        if (m_StatsInterval > 0.0)
+        {
+            m_StatsElapsed += deltaTime;
+            if (m_StatsElapsed >= m_StatsInterval)
+            {
+                MemoryStats stats;
+                GatherMemoryStats(stats);
+                stats.Dump(Runtime::Logger::GetLogger("ECS"));
+                m_StatsElapsed = 0.0;
+            }
+        }
+    }
+
+    void EntityManager::SwapEvents()
+    {
+        std::shared_lock lock(m_EventMutex);
+        for (auto& channel : m_EventChannels)
+        {
+            if (channel)
+                channel->Swap();
+        }
     }
 
     EntityManager::EntityId EntityManager::AddEntity(std::unique_ptr<Entity>&& entity)
     {
-        std::unique_lock lock(m_Mutex);
+        EntityId id = NextId();
+        return InsertEntity(std::move(entity), id) ? id : InvalidId;
+    }
+
+    std::size_t EntityManager::AddEntities(std::vector<std::unique_ptr<Entity>>& entities,
+                                           const EntityId* ids,
+                                           EntityId* idsOut)
+    {
+        std::size_t rejected = 0;
+        for (std::size_t i = 0; i < entities.size(); i++)
+        {
+            EntityId id = ids ? ids[i] : NextId();
+            if (!InsertEntity(std::move(entities[i]), id))
+            {
+                entities[rejected++] = std::move(entities[i]);
+                id = InvalidId;
+            }
+            if (idsOut)
+                idsOut[i] = id;
+        }
 
-        EntityId id = TL::UUID::Random();
-        auto pair = m_Entities.emplace(id, std::move(entity));
-        auto& e = *pair.first->second.get();
+        const std::size_t added = entities.size() - rejected;
+        entities.resize(rejected);
+        return added;
+    }
 
-        e.SetUniqueId(id);
-        e.SetEntityManager(this);
+    std::size_t EntityManager::RemoveEntities(std::span<const EntityId> ids,
+                                              std::vector<std::unique_ptr<Entity>>& entitiesOut)
+    {
+        std::unique_lock lock(m_SystemMutex);
+        std::size_t count = 0;
 
-        for (auto* system : m_Systems)
+        for (const EntityId& id : ids)
         {
-            if (system->NotifyEntity(e))
-                system->AddEntity(e);
+            Entity* entity = EraseEntity(id);
+            if (entity == nullptr)
+                continue;
+            entitiesOut.emplace_back(entity);
+            ++count;
         }
 
-        return id;
+        return count;
     }
 
     const Entity* EntityManager::GetEntity(EntityManager::EntityId id) const
     {
-        std::shared_lock lock(m_Mutex);
-        if (!m_Entities.contains(id))
+        const Shard& shard = GetShard(id);
+        std::shared_lock lock(shard.Mutex);
+
+        auto it = shard.Entities.find(id);
+        if (it == shard.Entities.end())
             return nullptr;
-        return m_Entities.at(id).get();
+        return it->second.get();
+    }
+
+    std::size_t EntityManager::GetEntityCount() const
+    {
+        std::size_t count = 0;
+        for (const auto& shard : m_Shards)
+        {
+            std::shared_lock lock(shard.Mutex);
+            count += shard.Entities.size();
+        }
+        return count;
+    }
+
+    void EntityManager::SetNameIndexEnabled(bool enabled)
+    {
+        // Each shard switches over under its own lock, so entities added concurrently
+        // are indexed exactly once, either here or by InsertEntity
+        for (auto& shard : m_Shards)
+        {
+            std::unique_lock lock(shard.Mutex);
+            if (shard.NameIndexed == enabled)
+                continue;
+            shard.NameIndexed = enabled;
+
+            std::unique_lock nameLock(m_NameMutex);
+            for (auto& pair : shard.Entities)
+            {
+                if (enabled)
+                    m_NameIndex.emplace(pair.second->GetNameId(), pair.second.get());
+                else
+                    UnindexName(*pair.second);
+            }
+        }
+    }
+
+    const Entity* EntityManager::FindEntity(std::string_view name) const
+    {
+        const auto id = TL::NameTable::GetGlobal().Find(name);
+        if (id == TL::NameTable::InvalidName)
+            return nullptr;
+
+        std::shared_lock lock(m_NameMutex);
+        auto it = m_NameIndex.find(id);
+        return it != m_NameIndex.end() ? it->second : nullptr;
+    }
+
+    std::size_t EntityManager::FindEntities(std::string_view name, std::vector<const Entity*>& entitiesOut) const
+    {
+        const auto id = TL::NameTable::GetGlobal().Find(name);
+        if (id == TL::NameTable::InvalidName)
+            return 0;
+
+        std::shared_lock lock(m_NameMutex);
+        auto range = m_NameIndex.equal_range(id);
+        const std::size_t start = entitiesOut.size();
+        for (auto it = range.first; it != range.second; ++it)
+            entitiesOut.push_back(it->second);
+        return entitiesOut.size() - start;
+    }
+
+    void EntityManager::UnindexName(const Entity& entity)
+    {
+        auto range = m_NameIndex.equal_range(entity.GetNameId());
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == &entity)
+            {
+                m_NameIndex.erase(it);
+                return;
+            }
+        }
+    }
+
+    MemoryStats EntityManager::CollectMemoryStats() const
+    {
+        std::shared_lock lock(m_SystemMutex);
+        MemoryStats stats;
+        GatherMemoryStats(stats);
+        return stats;
+    }
+
+    void EntityManager::SetMemoryStatsInterval(double seconds)
+    {
+        std::unique_lock lock(m_SystemMutex);
+        m_StatsInterval = seconds;
+        m_StatsElapsed = 0.0;
+    }
+
+    EntityManager::IdState EntityManager::GetIdState() const
+    {
+        return { m_IdPrefix, m_NextIdRange.load(std::memory_order_relaxed) };
+    }
+
+    void EntityManager::SetIdState(const IdState& state)
+    {
+        // A new serial makes every thread reserve a fresh range on its next ID
+        m_Serial = NextManagerSerial();
+        m_IdPrefix = state.Prefix;
+        m_NextIdRange = state.NextRange;
+    }
+
+    void EntityManager::GatherMemoryStats(MemoryStats& stats) const
+    {
+        using MapType = decltype(Shard::Entities);
+
+        // Approximation of a node-based hash map's allocations: the bucket array plus
+        // one node per element holding the value, a next pointer and the cached hash
+        constexpr std::size_t nodeSize = sizeof(MapType::value_type) + sizeof(void*) + sizeof(std::size_t);
+
+        struct Tally
+        {
+            ComponentMemoryStats Stats;
+            std::size_t Size = 0;
+        };
+
+        auto* registry = Reflect::ClassRegistry::GetInstance();
+        std::unordered_map<Reflect::ClassId, Tally> components;
+
+        auto tallyComponent = [&](Reflect::ClassId id) {
+            auto& tally = components[id];
+            if (tally.Stats.Count == 0)
+            {
+                const Reflect::Class* clazz = registry->GetClass(id);
+                tally.Stats.Class = id;
+                tally.Stats.Name = clazz ? clazz->GetName() : "<unregistered>";
+                tally.Size = clazz ? clazz->GetSize() : sizeof(Component);
+            }
+
+            tally.Stats.Count++;
+            tally.Stats.Bytes += tally.Size;
+        };
+
+        for (const auto& shard : m_Shards)
+        {
+            std::shared_lock lock(shard.Mutex);
+            stats.StorageBytes += shard.Entities.bucket_count() * sizeof(void*) +
+                                  shard.Entities.size() * nodeSize +
+                                  shard.Pending.capacity() * sizeof(Entity*);
+
+            for (const auto& pair : shard.Entities)
+            {
+                const Entity& entity = *pair.second;
+
+                stats.EntityCount++;
+                stats.EntityBytes += sizeof(Entity);
+                stats.ComponentMapBytes += entity.GetComponentMapMemory();
+
+                entity.ForEachComponent([&](Reflect::ClassId id, Component*) { tallyComponent(id); });
+            }
+        }
+
+        {
+            // Singleton and shared components are counted once, however many entities use them
+            std::shared_lock lock(m_SingletonMutex);
+            for (const auto& pair : m_Singletons)
+            {
+                if (pair.second)
+                    tallyComponent(pair.first);
+            }
+            for (const auto& pair : m_SharedComponents)
+                tallyComponent(pair.first);
+            stats.StorageBytes += m_Singletons.capacity() * sizeof(m_Singletons[0]) +
+                                  m_SharedComponents.capacity() * sizeof(m_SharedComponents[0]);
+        }
+
+        {
+            std::shared_lock lock(m_NameMutex);
+            stats.NameBytes = TL::NameTable::GetGlobal().GetMemoryUsage() +
+                              m_NameIndex.bucket_count() * sizeof(void*) +
+                              m_NameIndex.size() * (sizeof(decltype(m_NameIndex)::value_type) + 2 * sizeof(void*));
+        }
+
+        // Entity lists small enough to stay inline are part of the system itself
+        for (const auto* system : m_Systems)
+        {
+            if (!system->GetEntities().IsInline())
+                stats.SystemBytes += system->GetEntities().capacity() * sizeof(Entity*);
+        }
+
+        {
+            std::shared_lock lock(m_EventMutex);
+            stats.EventBytes += m_EventChannels.capacity() * sizeof(m_EventChannels[0]);
+            for (const auto& channel : m_EventChannels)
+            {
+                if (channel)
+                    stats.EventBytes += channel->GetMemoryUsage();
+            }
+        }
+
+        stats.Components.reserve(components.size());
+        for (const auto& pair : components)
+            stats.Components.push_back(pair.second.Stats);
+        std::sort(stats.Components.begin(), stats.Components.end(),
+                  [](const auto& a, const auto& b) { return a.Bytes > b.Bytes; });
+    }
+
+    EntityManager::EntityId EntityManager::NextId()
+    {
+        struct IdRange
+        {
+            std::uint64_t Owner = 0;
+            std::uint64_t Next = 0;
+            std::uint64_t End = 0;
+        };
+        static thread_local IdRange s_Range;
+
+        // Threads reserve a fresh range when they switch between managers
+        const std::uint64_t serial = m_Serial.load(std::memory_order_relaxed);
+        if (s_Range.Owner != serial || s_Range.Next == s_Range.End)
+        {
+            s_Range.Owner = serial;
+            s_Range.Next = m_NextIdRange.fetch_add(IdRangeSize, std::memory_order_relaxed);
+            s_Range.End = s_Range.Next + IdRangeSize;
+        }
+
+        // The low 16 bits of D come first in UUID order, rotate so IDs sort in allocation order
+        return EntityId(static_cast<std::uint32_t>(m_IdPrefix >> 32),
+                        static_cast<std::uint16_t>(m_IdPrefix >> 16),
+                        static_cast<std::uint16_t>(m_IdPrefix),
+                        std::rotl(s_Range.Next++, 16));
+    }
+
+    EntityManager::Shard& EntityManager::GetShard(const EntityId& id)
+    {
+        return const_cast<Shard&>(static_cast<const EntityManager*>(this)->GetShard(id));
+    }
+
+    const EntityManager::Shard& EntityManager::GetShard(const EntityId& id) const
+    {
+        // Mix both halves so sequential and random IDs spread evenly
+        const std::uint64_t hi = (static_cast<std::uint64_t>(id.a) << 32) | (static_cast<std::uint64_t>(id.b) << 16) | id.c;
+        const std::uint64_t h = (hi ^ id.d) * 0x9E3779B97F4A7C15ULL;
+        return m_Shards[h >> 60 & (ShardCount - 1)];
+    }
+
+    void EntityManager::TakePending(Shard& shard, std::vector<Entity*>& pendingOut)
+    {
+        pendingOut.swap(shard.Pending);
+        std::erase(pendingOut, nullptr);
+        for (Entity* e : pendingOut)
+            e->m_PendingIndex = Entity::NotPending;
+    }
+
+    void EntityManager::MergePending()
+    {
+        for (auto& shard : m_Shards)
+        {
+            std::vector<Entity*> pending;
+            {
+                std::unique_lock lock(shard.Mutex);
+                if (shard.Pending.empty())
+                    continue;
+                TakePending(shard, pending);
+            }
+
+            NotifySystems(pending);
+        }
+    }
+
+    void EntityManager::NotifySystems(const std::vector<Entity*>& entities)
+    {
+        for (auto* system : m_Systems)
+        {
+            for (Entity* e : entities)
+            {
+                if (system->NotifyEntity(*e))
+                    system->AddEntity(*e);
+            }
+        }
     }
 
     Entity* EntityManager::RemoveEntity(EntityManager::EntityId id)
     {
-        std::unique_lock lock(m_Mutex);
-        if (!m_Entities.contains(id))
+        std::unique_lock lock(m_SystemMutex);
+        return EraseEntity(id);
+    }
+
+    bool EntityManager::InsertEntity(std::unique_ptr<Entity>&& entity, EntityId id)
+    {
+        Shard& shard = GetShard(id);
+        std::unique_lock lock(shard.Mutex);
+
+        // Nothing about the entity changes unless the ID is free
+        auto pair = shard.Entities.try_emplace(id);
+        if (!pair.second)
+            return false;
+
+        Entity& e = *entity;
+        e.SetUniqueId(id);
+        e.SetEntityManager(this);
+        pair.first->second = std::move(entity);
+
+        e.m_PendingIndex = shard.Pending.size();
+        shard.Pending.push_back(&e);
+
+        if (shard.NameIndexed)
+        {
+            std::unique_lock nameLock(m_NameMutex);
+            m_NameIndex.emplace(e.GetNameId(), &e);
+        }
+        return true;
+    }
+
+    Entity* EntityManager::EraseEntity(EntityId id)
+    {
+        Shard& shard = GetShard(id);
+        std::unique_lock lock(shard.Mutex);
+
+        auto it = shard.Entities.find(id);
+        if (it == shard.Entities.end())
             return nullptr;
 
         // Release entity from smart pointer
-        Entity* entity = m_Entities.at(id).release();
+        Entity* entity = it->second.release();
 
-        // Notify systems that it is being removed
-        for (auto* system : m_Systems)
-            system->NotifyEntityRemoved(*entity);
+        if (shard.NameIndexed)
+        {
+            std::unique_lock nameLock(m_NameMutex);
+            UnindexName(*entity);
+        }
+
+        // Systems only know about the entity if it has been merged, otherwise its slot is
+        // cleared in place so removing a batch of fresh entities stays linear
+        if (entity->m_PendingIndex != Entity::NotPending)
+        {
+            shard.Pending[entity->m_PendingIndex] = nullptr;
+            entity->m_PendingIndex = Entity::NotPending;
+        }
+        else
+        {
+            for (auto* system : m_Systems)
+                system->NotifyEntityRemoved(*entity);
+        }
 
         // Erase it from the map
-        m_Entities.erase(id);
+        shard.Entities.erase(it);
         return entity;
     }
 
@@ -0,0 +1,214 @@
+#include <Exile/ECS/Interest.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace Exi::ECS
+{
+
+    InterestManager::InterestManager(float cellSize)
+        : m_CellSize(cellSize), m_InverseCellSize(1.0f / cellSize)
+    {
+
+    }
+
+    InterestManager::Handle InterestManager::AddEntity(const EntityId& id, float x, float y)
+    {
+        Handle handle;
+        if (m_FreeHandles.empty())
+        {
+            handle = static_cast<Handle>(m_Ids.size());
+            m_Ids.push_back(id);
+            m_X.push_back(x);
+            m_Y.push_back(y);
+            m_CellKeys.push_back(0);
+            m_CellSlots.push_back(0);
+            m_ObserverSlots.push_back(NoObserver);
+            m_Alive.push_back(1);
+        }
+        else
+        {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+            m_Ids[handle] = id;
+            m_X[handle] = x;
+            m_Y[handle] = y;
+            m_ObserverSlots[handle] = NoObserver;
+            m_Alive[handle] = 1;
+        }
+
+        InsertIntoCell(handle, MakeKey(ToCell(x), ToCell(y)));
+        return handle;
+    }
+
+    void InterestManager::MoveEntity(Handle handle, float x, float y)
+    {
+        m_X[handle] = x;
+        m_Y[handle] = y;
+
+        const CellKey key = MakeKey(ToCell(x), ToCell(y));
+        if (key == m_CellKeys[handle])
+        {
+            m_Cells[key].LastChanged = m_UpdateCount;
+            return;
+        }
+
+        RemoveFromCell(handle);
+        InsertIntoCell(handle, key);
+    }
+
+    void InterestManager::RemoveEntity(Handle handle)
+    {
+        if (!m_Alive[handle])
+            return;
+
+        RemoveObserver(handle);
+        RemoveFromCell(handle);
+        m_Alive[handle] = 0;
+
+        // Hold the handle back until observers have seen it leave
+        m_RemovedHandles.push_back(handle);
+    }
+
+    void InterestManager::AddObserver(Handle handle, float radius)
+    {
+        if (m_ObserverSlots[handle] != NoObserver)
+        {
+            m_Observers[m_ObserverSlots[handle]].Radius = radius;
+            m_Observers[m_ObserverSlots[handle]].LastUpdated = 0;
+            return;
+        }
+
+        m_ObserverSlots[handle] = static_cast<std::uint32_t>(m_Observers.size());
+        m_Observers.push_back({ handle, radius, m_X[handle], m_Y[handle] });
+    }
+
+    void InterestManager::RemoveObserver(Handle handle)
+    {
+        const std::uint32_t slot = m_ObserverSlots[handle];
+        if (slot == NoObserver)
+            return;
+
+        if (slot != m_Observers.size() - 1)
+        {
+            m_Observers[slot] = std::move(m_Observers.back());
+            m_ObserverSlots[m_Observers[slot].Entity] = slot;
+        }
+        m_Observers.pop_back();
+        m_ObserverSlots[handle] = NoObserver;
+    }
+
+    void InterestManager::Update()
+    {
+        for (auto& observer : m_Observers)
+            UpdateObserver(observer);
+
+        m_FreeHandles.insert(m_FreeHandles.end(), m_RemovedHandles.begin(), m_RemovedHandles.end());
+        m_RemovedHandles.clear();
+        m_UpdateCount++;
+    }
+
+    std::span<const InterestManager::Handle> InterestManager::GetEntered(Handle observer) const
+    {
+        const std::uint32_t slot = m_ObserverSlots[observer];
+        return slot == NoObserver ? std::span<const Handle>() : m_Observers[slot].Entered;
+    }
+
+    std::span<const InterestManager::Handle> InterestManager::GetLeft(Handle observer) const
+    {
+        const std::uint32_t slot = m_ObserverSlots[observer];
+        return slot == NoObserver ? std::span<const Handle>() : m_Observers[slot].Left;
+    }
+
+    std::span<const InterestManager::Handle> InterestManager::GetVisible(Handle observer) const
+    {
+        const std::uint32_t slot = m_ObserverSlots[observer];
+        return slot == NoObserver ? std::span<const Handle>() : m_Observers[slot].Visible;
+    }
+
+    std::int32_t InterestManager::ToCell(float v) const
+    {
+        return static_cast<std::int32_t>(std::floor(v * m_InverseCellSize));
+    }
+
+    InterestManager::CellKey InterestManager::MakeKey(std::int32_t cx, std::int32_t cy)
+    {
+        return (static_cast<CellKey>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+    }
+
+    void InterestManager::InsertIntoCell(Handle handle, CellKey key)
+    {
+        Cell& cell = m_Cells[key];
+        m_CellKeys[handle] = key;
+        m_CellSlots[handle] = static_cast<std::uint32_t>(cell.Members.size());
+        cell.Members.push_back(handle);
+        cell.LastChanged = m_UpdateCount;
+    }
+
+    void InterestManager::RemoveFromCell(Handle handle)
+    {
+        Cell& cell = m_Cells[m_CellKeys[handle]];
+        const std::uint32_t slot = m_CellSlots[handle];
+        cell.Members[slot] = cell.Members.back();
+        m_CellSlots[cell.Members[slot]] = slot;
+        cell.Members.pop_back();
+        cell.LastChanged = m_UpdateCount;
+    }
+
+    void InterestManager::UpdateObserver(Observer& observer)
+    {
+        const float x = m_X[observer.Entity];
+        const float y = m_Y[observer.Entity];
+        const std::int32_t minX = ToCell(x - observer.Radius), maxX = ToCell(x + observer.Radius);
+        const std::int32_t minY = ToCell(y - observer.Radius), maxY = ToCell(y + observer.Radius);
+
+        // Nothing can have entered or left if neither the observer nor anything around it moved
+        bool dirty = observer.LastUpdated == 0 || x != observer.LastX || y != observer.LastY;
+        for (std::int32_t cx = minX; cx <= maxX && !dirty; cx++)
+        {
+            for (std::int32_t cy = minY; cy <= maxY && !dirty; cy++)
+            {
+                const auto it = m_Cells.find(MakeKey(cx, cy));
+                dirty = it != m_Cells.end() && it->second.LastChanged > observer.LastUpdated;
+            }
+        }
+
+        observer.Entered.clear();
+        observer.Left.clear();
+        if (!dirty)
+            return;
+
+        const float radiusSquared = observer.Radius * observer.Radius;
+        m_Scratch.clear();
+        for (std::int32_t cx = minX; cx <= maxX; cx++)
+        {
+            for (std::int32_t cy = minY; cy <= maxY; cy++)
+            {
+                const auto it = m_Cells.find(MakeKey(cx, cy));
+                if (it == m_Cells.end())
+                    continue;
+
+                for (const Handle member : it->second.Members)
+                {
+                    const float dx = m_X[member] - x;
+                    const float dy = m_Y[member] - y;
+                    if (member != observer.Entity && dx * dx + dy * dy <= radiusSquared)
+                        m_Scratch.push_back(member);
+                }
+            }
+        }
+        std::sort(m_Scratch.begin(), m_Scratch.end());
+
+        std::set_difference(m_Scratch.begin(), m_Scratch.end(),
+                            observer.Visible.begin(), observer.Visible.end(),
+                            std::back_inserter(observer.Entered));
+        std::set_difference(observer.Visible.begin(), observer.Visible.end(),
+                            m_Scratch.begin(), m_Scratch.end(),
+                            std::back_inserter(observer.Left));
+        observer.Visible.swap(m_Scratch);
+
+        observer.LastX = x;
+        observer.LastY = y;
+        observer.LastUpdated = m_UpdateCount;
+    }
+
+}
@@ -0,0 +1,44 @@
+#include <Exile/ECS/MemoryStats.hpp>
+
+namespace Exi::ECS
+{
+
+    std::size_t MemoryStats::GetComponentBytes() const
+    {
+        std::size_t bytes = 0;
+        for (const auto& component : Components)
+            bytes += component.Bytes;
+        return bytes;
+    }
+
+    std::size_t MemoryStats::GetOverheadBytes() const
+    {
+        return EntityBytes + NameBytes + ComponentMapBytes + StorageBytes + SystemBytes + EventBytes;
+    }
+
+    const ComponentMemoryStats* MemoryStats::GetComponent(Reflect::ClassId id) const
+    {
+        for (const auto& component : Components)
+        {
+            if (component.Class == id)
+                return &component;
+        }
+        return nullptr;
+    }
+
+    void MemoryStats::Dump(Runtime::Logger& logger) const
+    {
+        logger.Info("%zu entities, %zu bytes total (%zu components, %zu overhead)",
+                    EntityCount, GetTotalBytes(), GetComponentBytes(), GetOverheadBytes());
+        logger.Info("  Entities:       %zu bytes", EntityBytes);
+        logger.Info("  Names:          %zu bytes", NameBytes);
+        logger.Info("  Component maps: %zu bytes", ComponentMapBytes);
+        logger.Info("  Storage:        %zu bytes", StorageBytes);
+        logger.Info("  Systems:        %zu bytes", SystemBytes);
+        logger.Info("  Events:         %zu bytes", EventBytes);
+
+        for (const auto& component : Components)
+            logger.Info("  %s: %zu instances, %zu bytes", component.Name, component.Count, component.Bytes);
+    }
+
+}
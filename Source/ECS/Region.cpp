@@ -0,0 +1,591 @@
+#include <Exile/ECS/Region.hpp>
+#include <Exile/ECS/Component.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace Exi::ECS
+{
+    #pragma region RegionSerializer
+    namespace RegionSerializer
+    {
+        static constexpr std::uint32_t Magic   = 0x47525845; // 'EXRG'
+        static constexpr std::uint32_t Version = 2;
+
+        /**
+         * Get the serialized size of a primitive field type
+         * @param type
+         * @return Size in bytes, 0 if the type can't be serialized
+         */
+        static std::size_t PrimitiveSize(TL::Type type)
+        {
+            switch (type)
+            {
+                case TL::TypeInt8:    return sizeof(std::int8_t);
+                case TL::TypeInt16:   return sizeof(std::int16_t);
+                case TL::TypeInt32:   return sizeof(std::int32_t);
+                case TL::TypeInt64:   return sizeof(std::int64_t);
+                case TL::TypeFloat:   return sizeof(float);
+                case TL::TypeDouble:  return sizeof(double);
+                case TL::TypeBoolean: return sizeof(bool);
+                case TL::TypeUUID:    return sizeof(TL::UUID);
+                default:
+                    return 0;
+            }
+        }
+
+        class ByteWriter
+        {
+        public:
+            explicit ByteWriter(std::vector<std::uint8_t>& bytes) : m_Bytes(bytes) { }
+
+            template <typename T> requires std::is_trivially_copyable_v<T>
+            void Write(const T& value) { WriteBytes(&value, sizeof(T)); }
+
+            void WriteBytes(const void* data, std::size_t count)
+            {
+                auto* bytes = static_cast<const std::uint8_t*>(data);
+                m_Bytes.insert(m_Bytes.end(), bytes, bytes + count);
+            }
+        private:
+            std::vector<std::uint8_t>& m_Bytes;
+        };
+
+        class ByteReader
+        {
+        public:
+            explicit ByteReader(const std::vector<std::uint8_t>& bytes) : m_Bytes(bytes) { }
+
+            template <typename T> requires std::is_trivially_copyable_v<T>
+            bool Read(T& value) { return ReadBytes(&value, sizeof(T)); }
+
+            bool ReadBytes(void* data, std::size_t count)
+            {
+                const std::uint8_t* bytes = Skip(count);
+                if (!bytes)
+                    return false;
+                std::memcpy(data, bytes, count);
+                return true;
+            }
+
+            /**
+             * Advance past `count` bytes
+             * @return Pointer to the skipped bytes, nullptr if the buffer is too short
+             */
+            const std::uint8_t* Skip(std::size_t count)
+            {
+                if (m_Bytes.size() - m_Offset < count)
+                    return nullptr;
+                const std::uint8_t* bytes = m_Bytes.data() + m_Offset;
+                m_Offset += count;
+                return bytes;
+            }
+        private:
+            const std::vector<std::uint8_t>& m_Bytes;
+            std::size_t m_Offset = 0;
+        };
+
+        /**
+         * Collect the serializable fields of a class and its super classes
+         * @param clazz
+         * @param fieldsOut
+         */
+        static void CollectFields(const Reflect::Class* clazz, std::vector<const Reflect::Field*>& fieldsOut)
+        {
+            auto* registry = Reflect::ClassRegistry::GetInstance();
+            std::vector<const Reflect::Field*> fields;
+
+            while (clazz != nullptr)
+            {
+                fields.resize(clazz->GetFieldCount());
+                fields.resize(clazz->GetFields(fields.data(), fields.size()));
+
+                for (const auto* field : fields)
+                {
+                    if (PrimitiveSize(field->GetType()) != 0)
+                        fieldsOut.push_back(field);
+                }
+
+                if (clazz->GetSuperId() == clazz->GetId())
+                    break;
+                clazz = registry->GetClass(clazz->GetSuperId());
+            }
+        }
+
+        ClassTable::ClassTable()
+        {
+            auto* registry = Reflect::ClassRegistry::GetInstance();
+            m_RegistryCount = registry->GetClassCount();
+
+            for (Reflect::ClassId id : registry->GetDerivedClasses(Component::Static::Id))
+            {
+                Entry& entry = m_Entries[id];
+                entry.Class = registry->GetClass(id);
+                CollectFields(entry.Class, entry.Fields);
+            }
+        }
+
+        const ClassTable::Entry* ClassTable::Find(Reflect::ClassId id) const
+        {
+            auto it = m_Entries.find(id);
+            return it != m_Entries.end() ? &it->second : nullptr;
+        }
+
+        void Write(const std::vector<const Entity*>& entities, const ClassTable& classes,
+                   std::vector<std::uint8_t>& bytesOut)
+        {
+            static const std::vector<const Reflect::Field*> noFields;
+            ByteWriter writer(bytesOut);
+
+            writer.Write(Magic);
+            writer.Write(Version);
+            writer.Write(static_cast<std::uint32_t>(entities.size()));
+
+            for (const Entity* entity : entities)
+            {
+                const auto name = entity->GetName();
+                std::uint32_t componentCount = 0;
+
+                writer.Write(entity->GetUniqueId());
+                writer.Write(static_cast<std::uint32_t>(name.size()));
+                writer.WriteBytes(name.data(), name.size());
+
+                entity->ForEachComponent([&](Reflect::ClassId, Component*) { ++componentCount; });
+                writer.Write(componentCount);
+
+                entity->ForEachComponent([&](Reflect::ClassId id, Component* component) {
+                    auto* base = reinterpret_cast<const std::uint8_t*>(static_cast<Reflect::ClassBase*>(component));
+
+                    const ClassTable::Entry* entry = classes.Find(id);
+                    const auto& fields = entry ? entry->Fields : noFields;
+
+                    writer.Write(static_cast<std::uint64_t>(id));
+                    writer.Write(static_cast<std::uint16_t>(fields.size()));
+                    for (const auto* field : fields)
+                    {
+                        const auto size = PrimitiveSize(field->GetType());
+                        writer.Write(static_cast<std::uint64_t>(field->GetId()));
+                        writer.Write(static_cast<std::uint8_t>(field->GetType()));
+                        writer.Write(static_cast<std::uint8_t>(size));
+                        writer.WriteBytes(base + field->GetOffset(), size);
+                    }
+                });
+            }
+        }
+
+        void Write(const std::vector<std::unique_ptr<Entity>>& entities, const ClassTable& classes,
+                   std::vector<std::uint8_t>& bytesOut)
+        {
+            std::vector<const Entity*> pointers;
+            pointers.reserve(entities.size());
+            for (const auto& entity : entities)
+                pointers.push_back(entity.get());
+            Write(pointers, classes, bytesOut);
+        }
+
+        void Write(const std::vector<std::unique_ptr<Entity>>& entities, std::vector<std::uint8_t>& bytesOut)
+        {
+            Write(entities, ClassTable(), bytesOut);
+        }
+
+        /**
+         * Read a single component and attach it to an entity
+         * @return True if the component record was well-formed, false otherwise
+         */
+        static bool ReadComponent(ByteReader& reader, Entity& entity, const ClassTable& classes)
+        {
+            std::uint64_t classId;
+            std::uint16_t fieldCount;
+
+            if (!reader.Read(classId) || !reader.Read(fieldCount))
+                return false;
+
+            // Unknown or non-component classes are skipped, but their fields still need to be consumed
+            const ClassTable::Entry* entry = classes.Find(classId);
+            Component* component = nullptr;
+            if (entry)
+                component = static_cast<Component*>(entry->Class->Construct());
+
+            for (std::uint16_t i = 0; i < fieldCount; i++)
+            {
+                std::uint64_t fieldId;
+                std::uint8_t type, size;
+
+                if (!reader.Read(fieldId) || !reader.Read(type) || !reader.Read(size))
+                {
+                    delete component;
+                    return false;
+                }
+
+                const std::uint8_t* data = reader.Skip(size);
+                if (!data)
+                {
+                    delete component;
+                    return false;
+                }
+
+                if (!component)
+                    continue;
+
+                auto field = std::find_if(entry->Fields.begin(), entry->Fields.end(),
+                                          [&](const Reflect::Field* f) { return f->GetId() == fieldId; });
+                if (field == entry->Fields.end() || (*field)->GetType() != type || PrimitiveSize((*field)->GetType()) != size)
+                    continue;
+
+                auto* base = reinterpret_cast<std::uint8_t*>(static_cast<Reflect::ClassBase*>(component));
+                std::memcpy(base + (*field)->GetOffset(), data, size);
+            }
+
+            if (component)
+                entity.AttachComponent(entry->Class->GetId(), component);
+            return true;
+        }
+
+        bool Read(const std::vector<std::uint8_t>& bytes, const ClassTable& classes,
+                  std::vector<std::unique_ptr<Entity>>& entitiesOut,
+                  std::vector<EntityManager::EntityId>& idsOut)
+        {
+            ByteReader reader(bytes);
+            std::uint32_t magic, version, entityCount;
+
+            if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(entityCount))
+                return false;
+            if (magic != Magic || version != Version)
+                return false;
+
+            std::string name;
+            for (std::uint32_t i = 0; i < entityCount; i++)
+            {
+                TL::UUID id;
+                std::uint32_t nameLength;
+                std::uint32_t componentCount;
+
+                if (!reader.Read(id) || !reader.Read(nameLength))
+                    return false;
+
+                name.resize(nameLength);
+                if (!reader.ReadBytes(name.data(), nameLength) || !reader.Read(componentCount))
+                    return false;
+
+                auto entity = std::make_unique<Entity>(name);
+                for (std::uint32_t c = 0; c < componentCount; c++)
+                {
+                    if (!ReadComponent(reader, *entity, classes))
+                        return false;
+                }
+
+                entitiesOut.push_back(std::move(entity));
+                idsOut.push_back(id);
+            }
+
+            return true;
+        }
+
+        bool Read(const std::vector<std::uint8_t>& bytes,
+                  std::vector<std::unique_ptr<Entity>>& entitiesOut,
+                  std::vector<EntityManager::EntityId>& idsOut)
+        {
+            return Read(bytes, ClassTable(), entitiesOut, idsOut);
+        }
+
+        std::size_t EstimateMemory(const Entity& entity)
+        {
+            auto* registry = Reflect::ClassRegistry::GetInstance();
+            std::size_t bytes = sizeof(Entity);
+
+            entity.ForEachComponent([&](Reflect::ClassId id, Component*) {
+                const Reflect::Class* clazz = registry->GetClass(id);
+                bytes += clazz ? clazz->GetSize() : sizeof(Component);
+            });
+
+            return bytes;
+        }
+    }
+    #pragma endregion
+
+    #pragma region RegionStreamer
+    RegionStreamer::RegionStreamer(EntityManager& manager,
+                                   Runtime::Filesystem& filesystem,
+                                   Runtime::Path directory,
+                                   std::size_t memoryBudget)
+        : m_Manager(manager), m_Filesystem(filesystem),
+          m_Logger(Runtime::Logger::GetLogger("Regions")),
+          m_Directory(std::move(directory)), m_MemoryBudget(memoryBudget)
+    {
+        GetClassTable();
+        m_Worker = std::thread(&RegionStreamer::WorkerMain, this);
+    }
+
+    RegionStreamer::~RegionStreamer()
+    {
+        {
+            std::unique_lock lock(m_JobMutex);
+            m_Stopping = true;
+        }
+        m_JobSignal.notify_one();
+        m_Worker.join();
+    }
+
+    void RegionStreamer::AddEntity(RegionCoord region, std::unique_ptr<Entity>&& entity)
+    {
+        auto it = m_Regions.find(region.Key());
+        if (it == m_Regions.end())
+        {
+            RequestRegion(region);
+            it = m_Regions.find(region.Key());
+        }
+
+        Region& r = it->second;
+        if (r.State == RegionState::Loading)
+        {
+            r.Pending.push_back(std::move(entity));
+            return;
+        }
+
+        const std::size_t memory = RegionSerializer::EstimateMemory(*entity);
+        r.Entities.push_back(m_Manager.AddEntity(std::move(entity)));
+        r.Memory += memory;
+        m_MemoryUsage += memory;
+    }
+
+    void RegionStreamer::RequestRegion(RegionCoord region)
+    {
+        auto pair = m_Regions.try_emplace(region.Key());
+        if (!pair.second)
+            return;
+
+        pair.first->second.Coord = region;
+        PushJob({ Job::Load, region });
+    }
+
+    void RegionStreamer::Update(RegionCoord focus, std::int32_t radius)
+    {
+        for (std::int32_t y = focus.Y - radius; y <= focus.Y + radius; y++)
+        {
+            for (std::int32_t x = focus.X - radius; x <= focus.X + radius; x++)
+                RequestRegion({ x, y });
+        }
+
+        // Take finished loads without holding the lock while inserting them, and written
+        // entities so their components are destroyed on this thread
+        std::vector<LoadResult> results;
+        std::vector<std::unique_ptr<Entity>> written;
+        {
+            std::unique_lock lock(m_ResultMutex);
+            results.swap(m_Results);
+            written.swap(m_Written);
+        }
+
+        for (auto& result : results)
+            Integrate(result);
+
+        if (m_MemoryUsage <= m_MemoryBudget)
+            return;
+
+        // Evict the furthest regions first
+        std::vector<Region*> candidates;
+        for (auto& pair : m_Regions)
+        {
+            Region& region = pair.second;
+            if (region.State == RegionState::Resident && region.Coord.Distance(focus) > radius)
+                candidates.push_back(&region);
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [&](const Region* a, const Region* b) {
+            return a->Coord.Distance(focus) > b->Coord.Distance(focus);
+        });
+
+        for (Region* region : candidates)
+        {
+            if (m_MemoryUsage <= m_MemoryBudget)
+                break;
+            Evict(*region, false);
+        }
+    }
+
+    void RegionStreamer::SaveAll()
+    {
+        for (auto& pair : m_Regions)
+        {
+            if (pair.second.State == RegionState::Resident)
+                Evict(pair.second, true);
+        }
+    }
+
+    std::span<const EntityManager::EntityId> RegionStreamer::GetEntities(RegionCoord region) const
+    {
+        auto it = m_Regions.find(region.Key());
+        if (it == m_Regions.end() || it->second.State != RegionState::Resident)
+            return { };
+        return it->second.Entities;
+    }
+
+    bool RegionStreamer::IsResident(RegionCoord region) const
+    {
+        auto it = m_Regions.find(region.Key());
+        return it != m_Regions.end() && it->second.State == RegionState::Resident;
+    }
+
+    std::size_t RegionStreamer::GetResidentCount() const
+    {
+        return std::count_if(m_Regions.begin(), m_Regions.end(), [](const auto& pair) {
+            return pair.second.State == RegionState::Resident;
+        });
+    }
+
+    Runtime::Path RegionStreamer::GetRegionPath(RegionCoord region) const
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%d_%d.region", region.X, region.Y);
+
+        Runtime::Path path = m_Directory;
+        path /= std::string(name);
+        return path;
+    }
+
+    const std::shared_ptr<const RegionSerializer::ClassTable>& RegionStreamer::GetClassTable()
+    {
+        // Classes can be registered lazily at any time, e.g. by GetClass<C>()
+        if (!m_Classes || m_Classes->GetRegistryCount() != Reflect::ClassRegistry::GetInstance()->GetClassCount())
+            m_Classes = std::make_shared<const RegionSerializer::ClassTable>();
+        return m_Classes;
+    }
+
+    void RegionStreamer::PushJob(Job&& job)
+    {
+        job.Classes = GetClassTable();
+        {
+            std::unique_lock lock(m_JobMutex);
+            m_Jobs.push_back(std::move(job));
+        }
+        m_JobSignal.notify_one();
+    }
+
+    void RegionStreamer::WorkerMain()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(m_JobMutex);
+                m_JobSignal.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+
+                // Pending jobs are finished before stopping so evicted regions aren't lost
+                if (m_Jobs.empty())
+                    return;
+
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+            }
+
+            if (job.Type == Job::Save)
+            {
+                RegionSerializer::Write(job.Entities, *job.Classes, job.Bytes);
+
+                std::unique_lock lock(m_ResultMutex);
+                std::move(job.Entities.begin(), job.Entities.end(), std::back_inserter(m_Written));
+            }
+
+            if (job.Type != Job::Load)
+            {
+                WriteRegion(job.Coord, job.Bytes);
+                continue;
+            }
+
+            LoadResult result { job.Coord };
+            LoadRegion(job.Coord, *job.Classes, result);
+
+            std::unique_lock lock(m_ResultMutex);
+            m_Results.push_back(std::move(result));
+        }
+    }
+
+    void RegionStreamer::LoadRegion(RegionCoord region, const RegionSerializer::ClassTable& classes,
+                                    LoadResult& result)
+    {
+        auto handle = m_Filesystem.Open(GetRegionPath(region), Runtime::Filesystem::ReadOnly);
+
+        // Regions without a file are new and start out empty
+        if (!handle)
+            return;
+
+        std::vector<std::uint8_t> bytes(handle.GetSize());
+        if (handle.ReadBytes(bytes.size(), bytes.data()) != bytes.size() ||
+            !RegionSerializer::Read(bytes, classes, result.Entities, result.Ids))
+        {
+            m_Logger.Error("Region file '%s' is corrupt", GetRegionPath(region).AsCString());
+            result.Entities.clear();
+            result.Ids.clear();
+        }
+    }
+
+    void RegionStreamer::WriteRegion(RegionCoord region, const std::vector<std::uint8_t>& bytes)
+    {
+        auto handle = m_Filesystem.Open(GetRegionPath(region), Runtime::Filesystem::WriteTruncate);
+        if (!handle || handle.WriteBytes(bytes.size(), bytes.data()) != bytes.size())
+            m_Logger.Error("Failed to write region file '%s'", GetRegionPath(region).AsCString());
+    }
+
+    void RegionStreamer::Integrate(LoadResult& result)
+    {
+        auto it = m_Regions.find(result.Coord.Key());
+        if (it == m_Regions.end())
+            return;
+
+        Region& region = it->second;
+        std::size_t memory = 0;
+
+        for (const auto& entity : result.Entities)
+            memory += RegionSerializer::EstimateMemory(*entity);
+        for (const auto& entity : region.Pending)
+            memory += RegionSerializer::EstimateMemory(*entity);
+
+        const std::size_t loaded = result.Entities.size();
+        region.Entities.resize(loaded + region.Pending.size());
+        m_Manager.AddEntities(result.Entities, result.Ids.data(), region.Entities.data());
+        m_Manager.AddEntities(region.Pending, nullptr, region.Entities.data() + loaded);
+
+        // Loaded entities whose ID is already live elsewhere are rejected and left behind
+        if (!result.Entities.empty())
+        {
+            m_Logger.Warn("Dropped %zu entities from region (%d, %d), their IDs are already in use",
+                          result.Entities.size(), region.Coord.X, region.Coord.Y);
+            for (const auto& entity : result.Entities)
+                memory -= RegionSerializer::EstimateMemory(*entity);
+            std::erase(region.Entities, EntityManager::InvalidId);
+        }
+
+        region.State = RegionState::Resident;
+        region.Memory = memory;
+        m_MemoryUsage += memory;
+    }
+
+    void RegionStreamer::Evict(Region& region, bool keepResident)
+    {
+        if (keepResident)
+        {
+            std::vector<const Entity*> entities;
+            for (const auto& id : region.Entities)
+            {
+                if (const Entity* entity = m_Manager.GetEntity(id))
+                    entities.push_back(entity);
+            }
+
+            // The entities stay live so they are serialized here, only the write is deferred
+            Job job { Job::Write, region.Coord };
+            RegionSerializer::Write(entities, *GetClassTable(), job.Bytes);
+            PushJob(std::move(job));
+            return;
+        }
+
+        // Evicted entities are handed to the background thread, which serializes them and hands them back
+        Job job { Job::Save, region.Coord };
+        m_Manager.RemoveEntities(region.Entities, job.Entities);
+        PushJob(std::move(job));
+
+        m_MemoryUsage -= region.Memory;
+        m_Regions.erase(region.Coord.Key());
+    }
+    #pragma endregion
+
+}
@@ -0,0 +1,189 @@
+#include <Exile/ECS/Session.hpp>
+#include <Exile/TL/UUID.hpp>
+
+namespace Exi::ECS
+{
+
+    static constexpr std::uint32_t Magic   = 0x53535845; // 'EXSS'
+    static constexpr std::uint32_t Version = 2;
+
+    /** Buffered bytes before the recorder writes them out */
+    static constexpr std::size_t FlushThreshold = 64 * 1024;
+
+    enum class Record : std::uint8_t
+    {
+        Seed    = 1,
+        Command = 2,
+        Tick    = 3,
+        End     = 4,
+        IdState = 5
+    };
+
+    #pragma region SessionRecorder
+    SessionRecorder::SessionRecorder(Runtime::Filesystem& filesystem, const Runtime::Path& path, EntityManager& manager,
+                                     std::uint64_t seed)
+        : m_File(filesystem.Open(path, Runtime::Filesystem::WriteTruncate))
+    {
+        m_Buffer.reserve(FlushThreshold);
+        m_Buffer.insert(m_Buffer.end(), reinterpret_cast<const std::uint8_t*>(&Magic),
+                        reinterpret_cast<const std::uint8_t*>(&Magic) + sizeof(Magic));
+        m_Buffer.insert(m_Buffer.end(), reinterpret_cast<const std::uint8_t*>(&Version),
+                        reinterpret_cast<const std::uint8_t*>(&Version) + sizeof(Version));
+
+        // Threads may hold part of a range reserved before the session, start every thread afresh
+        const auto ids = manager.GetIdState();
+        manager.SetIdState(ids);
+        m_Buffer.push_back(static_cast<std::uint8_t>(Record::IdState));
+        m_Buffer.insert(m_Buffer.end(), reinterpret_cast<const std::uint8_t*>(&ids),
+                        reinterpret_cast<const std::uint8_t*>(&ids) + sizeof(ids));
+        RecordSeed(seed);
+    }
+
+    SessionRecorder::~SessionRecorder()
+    {
+        m_Buffer.push_back(static_cast<std::uint8_t>(Record::End));
+        Flush();
+    }
+
+    void SessionRecorder::RecordSeed(std::uint64_t seed)
+    {
+        TL::UUID::Seed(seed);
+
+        m_Buffer.push_back(static_cast<std::uint8_t>(Record::Seed));
+        m_Buffer.insert(m_Buffer.end(), reinterpret_cast<const std::uint8_t*>(&seed),
+                        reinterpret_cast<const std::uint8_t*>(&seed) + sizeof(seed));
+    }
+
+    void SessionRecorder::RecordCommand(std::uint32_t type, const void* data, std::size_t size)
+    {
+        auto* bytes = static_cast<const std::uint8_t*>(data);
+
+        m_Buffer.push_back(static_cast<std::uint8_t>(Record::Command));
+        WriteVarInt(type);
+        WriteVarInt(size);
+        m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+    }
+
+    void SessionRecorder::Tick(EntityManager& manager, double deltaTime)
+    {
+        m_Buffer.push_back(static_cast<std::uint8_t>(Record::Tick));
+        m_Buffer.insert(m_Buffer.end(), reinterpret_cast<const std::uint8_t*>(&deltaTime),
+                        reinterpret_cast<const std::uint8_t*>(&deltaTime) + sizeof(deltaTime));
+        m_TickCount++;
+
+        if (m_Buffer.size() >= FlushThreshold)
+            Flush();
+
+        manager.TickSystems(deltaTime);
+    }
+
+    void SessionRecorder::Flush()
+    {
+        if (m_File.IsValid() && !m_Buffer.empty())
+            m_File.WriteBytes(m_Buffer.size(), m_Buffer.data());
+        m_Buffer.clear();
+    }
+
+    void SessionRecorder::WriteVarInt(std::uint64_t value)
+    {
+        // LEB128, command types and sizes are almost always a single byte
+        while (value >= 0x80)
+        {
+            m_Buffer.push_back(static_cast<std::uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        m_Buffer.push_back(static_cast<std::uint8_t>(value));
+    }
+    #pragma endregion
+
+    #pragma region SessionPlayer
+    SessionPlayer::SessionPlayer(Runtime::Filesystem& filesystem, const Runtime::Path& path)
+    {
+        auto handle = filesystem.Open(path, Runtime::Filesystem::ReadOnly);
+        if (!handle)
+            return;
+
+        m_Bytes.resize(handle.GetSize());
+        if (handle.ReadBytes(m_Bytes.size(), m_Bytes.data()) != m_Bytes.size())
+            return;
+
+        std::uint32_t magic, version;
+        if (!Read(magic) || !Read(version) || magic != Magic || version != Version)
+            return;
+        m_Valid = true;
+    }
+
+    bool SessionPlayer::Step(EntityManager& manager)
+    {
+        Record record;
+        while (m_Valid && Read(record))
+        {
+            switch (record)
+            {
+                case Record::Seed:
+                {
+                    std::uint64_t seed;
+                    if (!Read(seed))
+                        return false;
+                    TL::UUID::Seed(seed);
+                    break;
+                }
+                case Record::IdState:
+                {
+                    EntityManager::IdState ids;
+                    if (!Read(ids))
+                        return false;
+                    manager.SetIdState(ids);
+                    break;
+                }
+                case Record::Command:
+                {
+                    std::uint64_t type, size;
+                    if (!ReadVarInt(type) || !ReadVarInt(size) || size > m_Bytes.size() - m_Offset)
+                        return false;
+                    if (m_CommandHandler)
+                        m_CommandHandler(static_cast<std::uint32_t>(type), { m_Bytes.data() + m_Offset, size });
+                    m_Offset += size;
+                    break;
+                }
+                case Record::Tick:
+                {
+                    double deltaTime;
+                    if (!Read(deltaTime))
+                        return false;
+                    manager.TickSystems(deltaTime);
+                    m_TickCount++;
+                    return true;
+                }
+                case Record::End:
+                    m_Finished = true;
+                    return false;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    std::size_t SessionPlayer::Run(EntityManager& manager)
+    {
+        const std::size_t start = m_TickCount;
+        while (Step(manager));
+        return m_TickCount - start;
+    }
+
+    bool SessionPlayer::ReadVarInt(std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && m_Offset < m_Bytes.size(); shift += 7)
+        {
+            const std::uint8_t byte = m_Bytes[m_Offset++];
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+    #pragma endregion
+
+}
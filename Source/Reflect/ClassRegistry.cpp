@@ -24,6 +24,8 @@ namespace Exi::Reflect
     Class& ClassRegistry::RegisterClass(const Class& clazz, ClassId id)
     {
         auto pair = m_ClassMap.try_emplace(id, clazz);
+        if (pair.second)
+            RebuildHierarchy();
         return pair.first->second;
     }
 
@@ -37,6 +39,76 @@ namespace Exi::Reflect
         return m_ClassMap.contains(id) ? &m_ClassMap.at(id) : nullptr;
     }
 
+    bool ClassRegistry::IsA(ClassId id, ClassId baseId) const
+    {
+        const Class* theClass = GetClass(id);
+        const Class* baseClass = GetClass(baseId);
+        if (!theClass || !baseClass)
+            return false;
+        return theClass->IsA(*baseClass);
+    }
+
+    std::span<const ClassId> ClassRegistry::GetDerivedClasses(ClassId id) const
+    {
+        const Class* theClass = GetClass(id);
+        if (!theClass)
+            return { };
+
+        return { m_Hierarchy.data() + theClass->m_PreOrder,
+                 m_Hierarchy.data() + theClass->m_PostOrder };
+    }
+
+    void ClassRegistry::RebuildHierarchy()
+    {
+        std::unordered_map<ClassId, std::vector<ClassId>> children;
+        std::vector<ClassId> roots;
+
+        for (const auto& pair : m_ClassMap)
+        {
+            const Class& clazz = pair.second;
+            if (m_ClassMap.contains(clazz.GetSuperId()) && clazz.GetSuperId() != clazz.GetId())
+                children[clazz.GetSuperId()].push_back(clazz.GetId());
+            else
+                roots.push_back(clazz.GetId());
+        }
+
+        // Iterative depth-first walk, a class is entered once and exited once
+        struct Visit { ClassId id; bool exit; };
+        std::vector<Visit> stack;
+        std::uint32_t order = 0;
+
+        m_Hierarchy.clear();
+        m_Hierarchy.reserve(m_ClassMap.size());
+
+        for (ClassId root : roots)
+        {
+            stack.push_back({ root, false });
+            while (!stack.empty())
+            {
+                Visit visit = stack.back();
+                stack.pop_back();
+                Class& clazz = m_ClassMap.at(visit.id);
+
+                if (visit.exit)
+                {
+                    clazz.m_PostOrder = order;
+                    continue;
+                }
+
+                clazz.m_PreOrder = order++;
+                m_Hierarchy.push_back(visit.id);
+                stack.push_back({ visit.id, true });
+
+                auto it = children.find(visit.id);
+                if (it != children.end())
+                {
+                    for (ClassId child : it->second)
+                        stack.push_back({ child, false });
+                }
+            }
+        }
+    }
+
     void ClassRegistry::DumpClass(ClassId id) const
     {
         const Class* theClass = GetClass(id);
@@ -52,11 +52,16 @@ namespace Exi::Runtime
             fclose(m_File);
     }
 
-    bool FileControl::ReopenAs(int openMode)
+    bool FileControl::ReopenAs(int openMode, bool shared)
     {
+        if (openMode == Filesystem::WriteTruncate && shared)
+            return false;
+
         std::unique_lock lock(m_Mutex);
         if (!m_MemoryMapped && m_Readable)
         {
+            // Buffered writes would otherwise land in the file after it was truncated
+            fflush(m_File);
             FILE* file = fopen(m_PhysicalPath.AsCString(), OpenModeToString(openMode));
             if (!file)
             {
@@ -65,6 +70,11 @@ namespace Exi::Runtime
             fclose(m_File);
             m_File = file;
             m_OpenMode = openMode;
+            m_Writable = (openMode == Filesystem::ReadWrite) || (openMode == Filesystem::WriteTruncate);
+
+            fseek(m_File, 0, SEEK_END);
+            m_Size = ftell(m_File);
+            rewind(m_File);
         }
         return true;
     }
@@ -34,7 +34,7 @@ namespace Exi::Runtime
     #pragma region Filesystem
     Filesystem::Filesystem(const Path& rootDirectory)
         : m_Vfs(VfsNode::DirectoryMount, "/", rootDirectory.AsString()),
-          m_Logger(Logger::GetLogger("Filesystem")), m_TranslationCache(1024)
+          m_Logger(Logger::GetLogger("Filesystem")), m_TranslationCache(s_TranslationCacheBudget)
     {
 
     }
@@ -67,16 +67,36 @@ namespace Exi::Runtime
 
         if (it == m_Files.end())
         {
+            // Drop FCBs that no handle refers to anymore so their streams get closed
+            std::erase_if(m_Files, [](const auto& v) { return v.use_count() == 1; });
+
             // No FCB found for this path, create one
-            fcb = m_Files.emplace_back(new FileControl(*this, path, physicalPath, mode));
+            fcb = std::shared_ptr<FileControl>(new FileControl(*this, path, physicalPath, mode));
+            if (!fcb->IsOpen())
+                return { };
+            m_Files.push_back(fcb);
         }
         else
         {
             fcb = *it;
 
-            if (mode == ReadWrite && fcb->GetOpenMode() == Read)
+            // Besides m_Files and fcb, any other reference is a handle someone still holds
+            const bool shared = fcb.use_count() > 2;
+
+            if (mode == WriteTruncate)
+            {
+                // A cached FCB keeps the old contents whatever mode it was opened with,
+                // so truncating always means reopening the file
+                if (!fcb->ReopenAs(mode, shared))
+                {
+                    m_Logger.Error("Failed to truncate '%s'%s", physicalPath.AsCString(),
+                                   shared ? ", it is still open elsewhere" : "");
+                    return { };
+                }
+            }
+            else if (mode == ReadWrite && fcb->GetOpenMode() == Read)
             {
-                if (!fcb->ReopenAs(ReadWrite))
+                if (!fcb->ReopenAs(mode, shared))
                 {
                     m_Logger.Error("Failed to re-open '%s' as read/write", physicalPath.AsCString());
                     return { };
@@ -102,7 +122,7 @@ namespace Exi::Runtime
             return false;
         }
 
-        std::vector<std::string_view> fragments;
+        PathUtils::Fragments fragments;
         PathUtils::SplitPath(path, fragments);
 
         // Get exclusive access to the VFS because we're about to modify it
@@ -125,16 +145,13 @@ namespace Exi::Runtime
 
     bool Filesystem::TranslatePath(const Path& virtualPath, Path& physicalPath)
     {
-        std::unique_lock cacheLock(m_CacheMutex);
         const auto& path = virtualPath.AsString();
-
-        if (m_TranslationCache.Contains(path))
-        {
-            physicalPath = m_TranslationCache.Get(path);
+        if (m_TranslationCache.TryGet(path, physicalPath))
             return true;
-        }
 
-        std::vector<std::string_view> fragments;
+        std::shared_lock vfsLock(m_VfsMutex);
+
+        PathUtils::Fragments fragments;
         PathUtils::SplitPath(path, fragments);
 
         std::size_t endIndex;
@@ -149,12 +166,12 @@ namespace Exi::Runtime
             physicalPath /= fragments[i];
         }
 
-        m_TranslationCache.Put(path, physicalPath);
+        m_TranslationCache.Put(path, physicalPath, path.size() + physicalPath.AsString().size());
         return true;
     }
 
     VfsNode& Filesystem::MatchPath(const std::string& path,
-                                   const std::vector<std::string_view>& fragments,
+                                   std::span<const std::string_view> fragments,
                                    std::size_t& indexOut)
     {
         VfsNode* node = &m_Vfs;
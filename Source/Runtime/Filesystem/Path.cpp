@@ -8,7 +8,7 @@ namespace Exi::Runtime
         if (path.empty())
             return;
 
-        std::vector<std::string_view> fragments;
+        PathUtils::Fragments fragments;
         m_Fragments = PathUtils::SplitPath(path, fragments);
         m_Path.reserve(path.size());
 
@@ -20,7 +20,7 @@ namespace Exi::Runtime
 
         for (auto i = 0; i < m_Fragments; i++)
         {
-            const auto& s = fragments.at(i);
+            const auto& s = fragments[i];
             m_Path.append(s);
 
             if (i == m_Fragments - 1)
@@ -4,6 +4,12 @@
 #include <Exile/ECS/Entity.hpp>
 #include <Exile/ECS/Component.hpp>
 #include <Exile/ECS/EntityManager.hpp>
+#include <Exile/ECS/Interest.hpp>
+#include <Exile/ECS/Session.hpp>
+#include <Exile/ECS/SortedGroup.hpp>
+#include <random>
+#include <string>
+#include <thread>
 
 DefineComponent(TransformComponent)
 {
@@ -66,6 +72,33 @@ Exi::Unit::BenchmarkResults Benchmark_EntityGetComponentsOfType()
     return BENCHMARK_END(ComponentSearch);
 }
 
+Exi::Unit::BenchmarkResults Benchmark_EntityGetDerivedComponents()
+{
+    constexpr int count = 64;
+    Exi::ECS::Entity entity;
+    TransformComponent* components[count] = { 0 };
+
+    for (int i = 0; i < count / 2; i++)
+        entity.AttachComponent(std::make_unique<TransformComponent>());
+    for (int i = 0; i < count / 2; i++)
+        entity.AttachComponent(std::make_unique<ExtendedTransformComponent>());
+
+    // Resolved once per query, not per entity
+    auto classes = Exi::Reflect::ClassRegistry::GetInstance()->GetDerivedClasses(TransformComponent::Static::Id);
+
+    BENCHMARK_START(DerivedComponentSearch, 65536 * 16);
+    BENCHMARK_LOOP(DerivedComponentSearch)
+    {
+        int found = entity.GetComponentsOfType(classes, (Exi::ECS::Component**)components, count);
+        if (found != count)
+        {
+            BENCHMARK_FAIL(DerivedComponentSearch);
+            break;
+        }
+    }
+    return BENCHMARK_END(DerivedComponentSearch);
+}
+
 DeriveClass(MySystem, Exi::ECS::System)
 {
 public:
@@ -101,6 +134,9 @@ Exi::Unit::BenchmarkResults Benchmark_EntityManagerAddEntity()
     entity2->AttachComponent(std::make_unique<TransformComponent>());
     manager.AddEntity(std::move(entity2));
 
+    // Systems are notified of new entities when the manager merges them at the next tick
+    manager.TickSystems(0);
+
     BENCHMARK_START(AddEntity, 65536);
     BENCHMARK_LOOP(AddEntity)
     {
@@ -114,6 +150,52 @@ Exi::Unit::BenchmarkResults Benchmark_EntityManagerAddEntity()
     return BENCHMARK_END(AddEntity);
 }
 
+template <int Threads>
+Exi::Unit::BenchmarkResults Benchmark_EntityManagerConcurrentAddEntity()
+{
+    constexpr std::size_t spawns = 65536 * 4;
+    Exi::ECS::EntityManager manager;
+    MySystem system;
+    manager.RegisterSystem(&system);
+
+    std::vector<std::thread> producers;
+    BENCHMARK_START(ConcurrentAddEntity, spawns);
+    for (int t = 0; t < Threads; t++)
+    {
+        producers.emplace_back([&manager] {
+            for (std::size_t i = 0; i < spawns / Threads; i++)
+                manager.AddEntity(std::make_unique<Exi::ECS::Entity>());
+        });
+    }
+    for (auto& producer : producers)
+        producer.join();
+    manager.TickSystems(0);
+
+    if (manager.GetEntityCount() != spawns)
+        BENCHMARK_FAIL(ConcurrentAddEntity);
+    return BENCHMARK_END(ConcurrentAddEntity);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_EntityManagerFindEntity()
+{
+    Exi::ECS::EntityManager manager;
+    manager.SetNameIndexEnabled(true);
+    for (int i = 0; i < 10000; i++)
+        manager.AddEntity(std::make_unique<Exi::ECS::Entity>("Entity" + std::to_string(i)));
+    manager.AddEntity(std::make_unique<Exi::ECS::Entity>("Boss"));
+
+    BENCHMARK_START(FindEntity, 1048576);
+    BENCHMARK_LOOP(FindEntity)
+    {
+        if (manager.FindEntity("Boss") == nullptr)
+        {
+            BENCHMARK_FAIL(FindEntity);
+            break;
+        }
+    }
+    return BENCHMARK_END(FindEntity);
+}
+
 Exi::Unit::BenchmarkResults Benchmark_EntityManagerTickSystems()
 {
     constexpr int count = 4096;
@@ -145,10 +227,152 @@ Exi::Unit::BenchmarkResults Benchmark_EntityManagerTickSystems()
     return BENCHMARK_END(TickSystems);
 }
 
+struct CollisionEvent
+{
+    std::uint32_t A;
+    std::uint32_t B;
+};
+
+Exi::Unit::BenchmarkResults Benchmark_EventChannelPush()
+{
+    constexpr int perTick = 1024;
+    Exi::ECS::EntityManager manager;
+    auto& channel = manager.GetEventChannel<CollisionEvent>();
+
+    BENCHMARK_START(EventChannelPush, 1024);
+    BENCHMARK_LOOP(EventChannelPush)
+    {
+        for (std::uint32_t i = 0; i < perTick; i++)
+            channel.Push({ i, i + 1 });
+        manager.TickSystems(0);
+
+        if (channel.GetEventCount() != perTick)
+        {
+            BENCHMARK_FAIL(EventChannelPush);
+            break;
+        }
+    }
+    return BENCHMARK_END(EventChannelPush);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_InterestManagerUpdate()
+{
+    constexpr int entityCount = 20000, observerCount = 2000, movesPerTick = 2000;
+    constexpr float worldSize = 2048.0f;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(0.0f, worldSize);
+    std::uniform_real_distribution<float> step(-4.0f, 4.0f);
+
+    Exi::ECS::InterestManager interest(64.0f);
+    std::vector<Exi::ECS::InterestManager::Handle> handles;
+    for (int i = 0; i < entityCount; i++)
+        handles.push_back(interest.AddEntity(Exi::TL::UUID::Random(), position(rng), position(rng)));
+    for (int i = 0; i < observerCount; i++)
+        interest.AddObserver(handles[i * (entityCount / observerCount)], 64.0f);
+    interest.Update();
+
+    std::vector<std::pair<float, float>> positions;
+    for (int i = 0; i < entityCount; i++)
+        positions.emplace_back(position(rng), position(rng));
+
+    BENCHMARK_START(InterestManagerUpdate, 256);
+    BENCHMARK_LOOP(InterestManagerUpdate)
+    {
+        for (int i = 0; i < movesPerTick; i++)
+        {
+            const auto index = static_cast<std::size_t>(rng() % entityCount);
+            auto& [x, y] = positions[index];
+            x += step(rng);
+            y += step(rng);
+            interest.MoveEntity(handles[index], x, y);
+        }
+        interest.Update();
+    }
+    return BENCHMARK_END(InterestManagerUpdate);
+}
+
+DefineComponent(DepthComponent)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class)
+    {
+        ExposeField(Class, Depth);
+    }
+
+    std::uint32_t Depth = 0;
+};
+
+Exi::Unit::BenchmarkResults Benchmark_SortedGroupSort(std::size_t changesPerTick)
+{
+    constexpr std::size_t entityCount = 10000;
+    std::mt19937 rng(1234);
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::SortedGroup<DepthComponent> group([](const DepthComponent& c) { return c.Depth; });
+    manager.RegisterSystem(&group);
+
+    std::vector<DepthComponent*> depths;
+    for (std::size_t i = 0; i < entityCount; i++)
+    {
+        auto entity = std::make_unique<Exi::ECS::Entity>();
+        auto depth = std::make_unique<DepthComponent>();
+        depth->Depth = rng() % 65536;
+        depths.push_back(depth.get());
+        entity->AttachComponent(std::move(depth));
+        manager.AddEntity(std::move(entity));
+    }
+    group.Sort();
+
+    BENCHMARK_START(SortedGroupSort, 4096);
+    BENCHMARK_LOOP(SortedGroupSort)
+    {
+        for (std::size_t i = 0; i < changesPerTick; i++)
+            depths[rng() % entityCount]->Depth = rng() % 65536;
+        group.Sort();
+    }
+    return BENCHMARK_END(SortedGroupSort);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_SessionPlayerRun()
+{
+    constexpr std::size_t ticks = 65536;
+    Exi::Runtime::Filesystem fs;
+    {
+        Exi::ECS::EntityManager manager;
+        Exi::ECS::SessionRecorder recorder(fs, "Benchmark.session", manager, 1);
+        for (std::size_t i = 0; i < ticks; i++)
+        {
+            recorder.RecordCommand(1, i);
+            recorder.Tick(manager, 1.0 / 60.0);
+        }
+    }
+
+    Exi::ECS::SessionPlayer player(fs, "Benchmark.session");
+    Exi::ECS::EntityManager manager;
+    std::size_t commands = 0;
+    player.SetCommandHandler([&](std::uint32_t, std::span<const std::uint8_t>) { commands++; });
+
+    BENCHMARK_START(SessionPlayerRun, ticks);
+    if (player.Run(manager) != ticks || commands != ticks)
+        BENCHMARK_FAIL(SessionPlayerRun);
+    return BENCHMARK_END(SessionPlayerRun);
+}
+
 bool Benchmark()
 {
     Exi::Unit::RunBenchmark("Entity::GetComponentsOfType", Benchmark_EntityGetComponentsOfType);
+    Exi::Unit::RunBenchmark("Entity::GetComponentsOfType (derived)", Benchmark_EntityGetDerivedComponents);
     Exi::Unit::RunBenchmark("EntityManager::AddEntity", Benchmark_EntityManagerAddEntity);
+    Exi::Unit::RunBenchmark("EntityManager::AddEntity (1 thread)", Benchmark_EntityManagerConcurrentAddEntity<1>);
+    Exi::Unit::RunBenchmark("EntityManager::AddEntity (2 threads)", Benchmark_EntityManagerConcurrentAddEntity<2>);
+    Exi::Unit::RunBenchmark("EntityManager::AddEntity (4 threads)", Benchmark_EntityManagerConcurrentAddEntity<4>);
+    Exi::Unit::RunBenchmark("EntityManager::AddEntity (8 threads)", Benchmark_EntityManagerConcurrentAddEntity<8>);
+    Exi::Unit::RunBenchmark("EntityManager::AddEntity (16 threads)", Benchmark_EntityManagerConcurrentAddEntity<16>);
+    Exi::Unit::RunBenchmark("EntityManager::FindEntity (10k entities)", Benchmark_EntityManagerFindEntity);
     Exi::Unit::RunBenchmark("EntityManager::TickSystems", Benchmark_EntityManagerTickSystems);
+    Exi::Unit::RunBenchmark("EventChannel::Push (1024/tick)", Benchmark_EventChannelPush);
+    Exi::Unit::RunBenchmark("SortedGroup::Sort (10k, 1% changed)", [] { return Benchmark_SortedGroupSort(100); });
+    Exi::Unit::RunBenchmark("SortedGroup::Sort (10k, all changed)", [] { return Benchmark_SortedGroupSort(10000); });
+    Exi::Unit::RunBenchmark("SessionPlayer::Run (per tick)", Benchmark_SessionPlayerRun);
+    Exi::Unit::RunBenchmark("InterestManager::Update (2k observers, 20k entities)", Benchmark_InterestManagerUpdate);
     return true;
 }
\ No newline at end of file
@@ -4,6 +4,16 @@
 #include <Exile/ECS/Component.hpp>
 #include <Exile/ECS/Entity.hpp>
 #include <Exile/ECS/EntityManager.hpp>
+#include <Exile/ECS/Interest.hpp>
+#include <Exile/ECS/Region.hpp>
+#include <Exile/ECS/Session.hpp>
+#include <Exile/ECS/SortedGroup.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <unordered_set>
 
 extern bool Benchmark();
 
@@ -28,6 +38,12 @@ private:
     int Z = 0;
 };
 
+DeriveComponent(VelocityPositionComponent, PositionComponent)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class) { }
+};
+
 bool Test_ComponentConstruction()
 {
     PositionComponent positionComponent;
@@ -57,6 +73,35 @@ bool Test_EntityComponentSearch()
     return count == 2;
 }
 
+bool Test_EntityDerivedComponentSearch()
+{
+    Exi::ECS::Entity entity;
+    entity.AttachComponent(std::make_unique<PositionComponent>());
+    entity.AttachComponent(std::make_unique<VelocityPositionComponent>());
+    entity.AttachComponent(std::make_unique<VelocityPositionComponent>());
+
+    std::vector<PositionComponent*> exact, derived;
+    int exactCount = entity.GetComponentsOfType<PositionComponent>(exact);
+    int derivedCount = entity.GetComponentsOfType<PositionComponent>(derived, true);
+
+    return exactCount == 1 && derivedCount == 3 &&
+        entity.GetComponentCount<VelocityPositionComponent>(true) == 2;
+}
+
+bool Test_EntityDetachComponent()
+{
+    Exi::ECS::Entity entity;
+    auto* first = new PositionComponent();
+    auto* second = new PositionComponent();
+    entity.AttachComponent(std::unique_ptr<PositionComponent>(first));
+    entity.AttachComponent(std::unique_ptr<PositionComponent>(second));
+
+    PositionComponent stranger;
+    auto detached = entity.DetachComponent(first);
+    return detached.get() == first && !entity.DetachComponent(&stranger) &&
+        entity.GetComponentCount<PositionComponent>() == 1 && entity.GetComponent<PositionComponent>() == second;
+}
+
 bool Test_EntityManagerGetEntity()
 {
     constexpr int count = 64;
@@ -74,6 +119,702 @@ bool Test_EntityManagerGetEntity()
     return e->GetComponentCount<PositionComponent>() == 1;
 }
 
+bool Test_EntityIdOrder()
+{
+    // IDs a thread allocates from one manager sort in allocation order
+    Exi::ECS::EntityManager manager;
+    auto last = manager.AddEntity(std::make_unique<Exi::ECS::Entity>());
+    for (int i = 0; i < 100000; i++)
+    {
+        const auto id = manager.AddEntity(std::make_unique<Exi::ECS::Entity>());
+        if (!(last < id))
+            return false;
+        last = id;
+    }
+    return true;
+}
+
+struct DamageEvent
+{
+    int Target;
+    int Amount;
+};
+
+bool Test_EventChannel()
+{
+    constexpr int threadCount = 8;
+    constexpr int perThread = 1000;
+    Exi::ECS::EntityManager manager;
+    auto& channel = manager.GetEventChannel<DamageEvent>();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+        threads.emplace_back([&, t]{
+            for (int i = 0; i < perThread; i++)
+                channel.Push({ t, i });
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    // Nothing is visible until the channel is swapped
+    if (!manager.GetEvents<DamageEvent>().empty())
+        return false;
+
+    manager.TickSystems(0);
+
+    long sum = 0;
+    for (const auto& event : manager.GetEvents<DamageEvent>())
+        sum += event.Amount;
+
+    if (sum != static_cast<long>(threadCount) * (perThread * (perThread - 1) / 2))
+        return false;
+
+    // Events only live for one tick
+    manager.TickSystems(0);
+    return manager.GetEvents<DamageEvent>().empty();
+}
+
+DefineComponent(HealthComponent)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class)
+    {
+        ExposeField(Class, Health);
+        ExposeField(Class, Armor);
+    }
+
+    int Health = 100;
+    double Armor = 0.5;
+};
+
+bool Test_InterestManager()
+{
+    using Handle = Exi::ECS::InterestManager::Handle;
+    Exi::ECS::InterestManager interest(16.0f);
+    auto contains = [](std::span<const Handle> set, Handle handle) {
+        return std::find(set.begin(), set.end(), handle) != set.end();
+    };
+
+    const Handle observer = interest.AddEntity(Exi::TL::UUID::Random(), 0.0f, 0.0f);
+    const Handle near = interest.AddEntity(Exi::TL::UUID::Random(), 5.0f, 5.0f);
+    const Handle far = interest.AddEntity(Exi::TL::UUID::Random(), 100.0f, 0.0f);
+    interest.AddObserver(observer, 20.0f);
+
+    interest.Update();
+    if (interest.GetEntered(observer).size() != 1 || !contains(interest.GetEntered(observer), near))
+        return false;
+
+    // Nothing moved, so nothing enters or leaves but the visible set stays
+    interest.Update();
+    if (!interest.GetEntered(observer).empty() || !interest.GetLeft(observer).empty() ||
+        !contains(interest.GetVisible(observer), near))
+        return false;
+
+    interest.MoveEntity(far, 10.0f, -10.0f);
+    interest.MoveEntity(near, 60.0f, 0.0f);
+    interest.Update();
+    if (!contains(interest.GetEntered(observer), far) || !contains(interest.GetLeft(observer), near))
+        return false;
+
+    // Removed entities leave even if their handle gets reused right after
+    interest.RemoveEntity(far);
+    interest.Update();
+    if (!contains(interest.GetLeft(observer), far) || !interest.GetVisible(observer).empty())
+        return false;
+
+    const Handle reused = interest.AddEntity(Exi::TL::UUID::Random(), 1.0f, 1.0f);
+    interest.Update();
+    return contains(interest.GetEntered(observer), reused) && interest.GetEntityCount() == 3;
+}
+
+bool Test_RegionSerializer()
+{
+    std::vector<std::unique_ptr<Exi::ECS::Entity>> entities, loaded;
+    std::vector<Exi::ECS::EntityManager::EntityId> ids;
+    std::vector<std::uint8_t> bytes;
+
+    auto health = std::make_unique<HealthComponent>();
+    health->Health = 42;
+    health->Armor = 2.25;
+
+    entities.push_back(std::make_unique<Exi::ECS::Entity>("Boss"));
+    entities.back()->AttachComponent(std::move(health));
+    entities.back()->AttachComponent(std::make_unique<PositionComponent>());
+
+    Exi::ECS::RegionSerializer::Write(entities, bytes);
+    if (!Exi::ECS::RegionSerializer::Read(bytes, loaded, ids) || loaded.size() != 1)
+        return false;
+
+    auto* component = loaded[0]->GetComponent<HealthComponent>();
+    if (loaded[0]->GetName() != "Boss" || loaded[0]->GetComponentCount<PositionComponent>() != 1 ||
+        !component || component->Health != 42 || component->Armor != 2.25)
+        return false;
+
+    // Names longer than 16 bits can count don't throw off the records after them
+    const std::string longName(70000, 'N');
+    entities.clear();
+    entities.push_back(std::make_unique<Exi::ECS::Entity>(longName));
+    entities.push_back(std::make_unique<Exi::ECS::Entity>("After"));
+    bytes.clear();
+    loaded.clear();
+    ids.clear();
+    Exi::ECS::RegionSerializer::Write(entities, bytes);
+    return Exi::ECS::RegionSerializer::Read(bytes, loaded, ids) && loaded.size() == 2 &&
+        loaded[0]->GetName() == longName && loaded[1]->GetName() == "After";
+}
+
+DefineComponent(ThreadBoundComponent)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class) { }
+
+    ~ThreadBoundComponent() override
+    {
+        if (std::this_thread::get_id() != Owner)
+            DestroyedElsewhere = true;
+    }
+
+    static inline std::thread::id Owner;
+    static inline std::atomic_bool DestroyedElsewhere = false;
+};
+
+bool Test_RegionStreamer()
+{
+    using namespace std::chrono_literals;
+    const Exi::ECS::RegionCoord near = { 0, 0 }, far = { 5, 0 };
+
+    // Region files left over from a previous run would be loaded alongside the new entities
+    std::filesystem::remove_all("Regions");
+    std::filesystem::create_directories("Regions");
+    Exi::Runtime::Filesystem fs;
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::RegionStreamer streamer(manager, fs, "Regions", SIZE_MAX);
+
+    auto wait = [&](Exi::ECS::RegionCoord focus, Exi::ECS::RegionCoord region) {
+        for (int i = 0; i < 1000 && !streamer.IsResident(region); i++)
+        {
+            streamer.Update(focus, 0);
+            std::this_thread::sleep_for(1ms);
+        }
+        return streamer.IsResident(region);
+    };
+
+    auto entity = std::make_unique<Exi::ECS::Entity>("FarAway");
+    entity->AttachComponent(std::make_unique<HealthComponent>());
+    ThreadBoundComponent::Owner = std::this_thread::get_id();
+    entity->AttachComponent(std::make_unique<ThreadBoundComponent>());
+    entity->GetComponent<HealthComponent>()->Health = 7;
+    streamer.AddEntity(far, std::move(entity));
+    streamer.AddEntity(near, std::make_unique<Exi::ECS::Entity>("Nearby"));
+
+    if (!wait(near, near) || !wait(near, far) || streamer.GetEntities(far).size() != 1)
+        return false;
+    const auto id = streamer.GetEntities(far)[0];
+
+    // Over budget, the far region gets written out and its entities leave the manager
+    streamer.SetMemoryBudget(1);
+    streamer.Update(near, 0);
+    if (streamer.IsResident(far) || manager.GetEntity(id) != nullptr)
+        return false;
+
+    // Moving the focus brings it back with the same entity ID
+    if (!wait(far, far) || streamer.IsResident(near))
+        return false;
+
+    // Components of evicted entities are destroyed on this thread, not the streamer's
+    const auto* reloaded = manager.GetEntity(id);
+    return reloaded && reloaded->GetName() == "FarAway" &&
+        reloaded->GetComponent<HealthComponent>()->Health == 7 &&
+        reloaded->GetComponent<ThreadBoundComponent>() && !ThreadBoundComponent::DestroyedElsewhere;
+}
+
+bool Test_RegionStreamer_Reload()
+{
+    using namespace std::chrono_literals;
+    const Exi::ECS::RegionCoord home = { 0, 0 }, region = { 3, 0 };
+
+    std::filesystem::remove_all("ReloadRegions");
+    std::filesystem::create_directories("ReloadRegions");
+
+    auto wait = [](Exi::ECS::RegionStreamer& streamer, Exi::ECS::RegionCoord focus) {
+        for (int i = 0; i < 1000 && !streamer.IsResident(focus); i++)
+        {
+            streamer.Update(focus, 0);
+            std::this_thread::sleep_for(1ms);
+        }
+        return streamer.IsResident(focus);
+    };
+
+    // Home is already resident, so evicting opens no other file that could flush the file cache
+    auto evict = [&](Exi::ECS::RegionStreamer& streamer) {
+        streamer.SetMemoryBudget(1);
+        streamer.Update(home, 0);
+        streamer.SetMemoryBudget(SIZE_MAX);
+    };
+
+    // Write the region file once, with two entities in it
+    {
+        Exi::Runtime::Filesystem fs;
+        Exi::ECS::EntityManager manager;
+        Exi::ECS::RegionStreamer streamer(manager, fs, "ReloadRegions", SIZE_MAX);
+        auto kept = std::make_unique<Exi::ECS::Entity>("Kept");
+        kept->AttachSharedComponent(manager.CreateSharedComponent<PositionComponent>());
+        streamer.AddEntity(region, std::move(kept));
+        streamer.AddEntity(region, std::make_unique<Exi::ECS::Entity>("RemovedWithAVeryLongName"));
+        if (!wait(streamer, home) || !wait(streamer, region))
+            return false;
+        evict(streamer);
+    }
+
+    // A fresh filesystem loads it read-only, then evicting has to truncate that same file
+    Exi::Runtime::Filesystem fs;
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::RegionStreamer streamer(manager, fs, "ReloadRegions", SIZE_MAX);
+    if (!wait(streamer, home) || !wait(streamer, region) || streamer.GetEntities(region).size() != 2)
+        return false;
+
+    std::vector<std::unique_ptr<Exi::ECS::Entity>> removed;
+    const auto ids = streamer.GetEntities(region);
+    for (const auto id : ids)
+    {
+        if (manager.GetEntity(id)->GetName() != "Kept")
+            manager.RemoveEntities({ &id, 1 }, removed);
+    }
+
+    // The second save is shorter, nothing of the first may be left behind
+    for (int cycle = 0; cycle < 2; cycle++)
+    {
+        evict(streamer);
+        if (streamer.IsResident(region) || !wait(streamer, region))
+            return false;
+
+        // Shared component references aren't persisted, the reloaded entity comes back without them
+        const auto reloaded = streamer.GetEntities(region);
+        if (reloaded.size() != 1 || manager.GetEntity(reloaded[0])->GetName() != "Kept" ||
+            manager.GetEntity(reloaded[0])->GetComponent<PositionComponent>() != nullptr)
+            return false;
+    }
+    return removed.size() == 1;
+}
+
+DefineComponent(LayerComponent)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class)
+    {
+        ExposeField(Class, Layer);
+    }
+
+    std::uint32_t Layer = 0;
+};
+
+bool Test_SortedGroup()
+{
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::SortedGroup<LayerComponent> group([](const LayerComponent& c) { return c.Layer; });
+    manager.RegisterSystem(&group);
+
+    std::vector<LayerComponent*> layers;
+    std::vector<Exi::ECS::EntityManager::EntityId> ids;
+    for (std::uint32_t i = 0; i < 1024; i++)
+    {
+        auto entity = std::make_unique<Exi::ECS::Entity>();
+        auto layer = std::make_unique<LayerComponent>();
+        layer->Layer = (i * 7919) % 1000;
+        layers.push_back(layer.get());
+        entity->AttachComponent(std::move(layer));
+        ids.push_back(manager.AddEntity(std::move(entity)));
+    }
+    manager.AddEntity(std::make_unique<Exi::ECS::Entity>("NoLayer"));
+
+    auto sorted = [&]() {
+        const auto entries = group.GetEntries();
+        const auto& entities = group.GetEntities();
+        for (std::size_t i = 0; i < entries.size(); i++)
+        {
+            if (entities[i] != entries[i].Entity || entries[i].Key != entries[i].Component->Layer)
+                return false;
+        }
+        return std::is_sorted(entries.begin(), entries.end(),
+                              [](const auto& a, const auto& b) { return a.Key < b.Key; });
+    };
+
+    // Initial fill goes through the radix sort, a handful of changes through insertion
+    manager.TickSystems(0);
+    if (group.GetEntries().size() != 1024 || !sorted())
+        return false;
+
+    layers[3]->Layer = 0;
+    layers[500]->Layer = 999999;
+    manager.TickSystems(0);
+    if (!sorted() || group.GetEntries().back().Component != layers[500])
+        return false;
+
+    // Removed entities are skipped right away and dropped by the next sort, the rest stay in order
+    std::vector<std::unique_ptr<Exi::ECS::Entity>> removed;
+    manager.RemoveEntities(std::span(ids).subspan(0, 10), removed);
+    std::size_t visited = 0;
+    group.ForEach([&](Exi::ECS::Entity&, LayerComponent&) { visited++; });
+    if (visited != 1014)
+        return false;
+
+    // An entity added back before that sort must not lose its new entry
+    const auto* readded = removed.back().get();
+    manager.AddEntity(std::move(removed.back()));
+    removed.pop_back();
+    manager.TickSystems(0);
+    const auto& entities = group.GetEntities();
+    return group.GetEntries().size() == 1015 && entities.size() == 1015 && sorted() &&
+        std::count(entities.begin(), entities.end(), readded) == 1;
+}
+
+bool Test_EntityManagerConcurrentAdd()
+{
+    constexpr int threads = 8, perThread = 4096;
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::SortedGroup<LayerComponent> group([](const LayerComponent& c) { return c.Layer; });
+    manager.RegisterSystem(&group);
+
+    std::vector<std::vector<Exi::ECS::EntityManager::EntityId>> ids(threads);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++)
+    {
+        producers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; i++)
+            {
+                auto entity = std::make_unique<Exi::ECS::Entity>();
+                if (i % 2 == 0)
+                    entity->AttachComponent(std::make_unique<LayerComponent>());
+                ids[t].push_back(manager.AddEntity(std::move(entity)));
+            }
+        });
+    }
+    for (auto& producer : producers)
+        producer.join();
+
+    // Systems only see new entities once they've been merged
+    if (!group.GetEntities().empty())
+        return false;
+    manager.TickSystems(0);
+
+    std::unordered_set<Exi::ECS::EntityManager::EntityId> unique;
+    for (const auto& list : ids)
+    {
+        for (const auto& id : list)
+        {
+            if (!unique.insert(id).second || manager.GetEntity(id) == nullptr)
+                return false;
+        }
+    }
+
+    return manager.GetEntityCount() == threads * perThread &&
+        group.GetEntities().size() == threads * perThread / 2;
+}
+
+bool Test_EntityManagerRegisterDuringAdd()
+{
+    constexpr int threads = 4, perThread = 4096;
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::SortedGroup<LayerComponent> early([](const LayerComponent& c) { return c.Layer; });
+    Exi::ECS::SortedGroup<LayerComponent> late([](const LayerComponent& c) { return c.Layer; });
+    manager.RegisterSystem(&early);
+
+    std::atomic_bool start = false;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++)
+    {
+        producers.emplace_back([&] {
+            while (!start)
+                std::this_thread::yield();
+            for (int i = 0; i < perThread; i++)
+            {
+                auto entity = std::make_unique<Exi::ECS::Entity>();
+                entity->AttachComponent(std::make_unique<LayerComponent>());
+                manager.AddEntity(std::move(entity));
+                if (i % 256 == 0)
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // Registered while entities are being added, every system must see each entity exactly once
+    start = true;
+    std::this_thread::yield();
+    manager.RegisterSystem(&late);
+    for (auto& producer : producers)
+        producer.join();
+    manager.TickSystems(0);
+
+    for (const auto* group : { &early, &late })
+    {
+        const auto& entities = group->GetEntities();
+        std::unordered_set<const Exi::ECS::Entity*> unique(entities.begin(), entities.end());
+        if (entities.size() != threads * perThread || unique.size() != entities.size())
+            return false;
+    }
+    return true;
+}
+
+bool Test_EntityManagerRemovePending()
+{
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::SortedGroup<LayerComponent> group([](const LayerComponent& c) { return c.Layer; });
+    manager.RegisterSystem(&group);
+
+    std::vector<Exi::ECS::EntityManager::EntityId> ids, removedIds;
+    for (int i = 0; i < 4096; i++)
+    {
+        auto entity = std::make_unique<Exi::ECS::Entity>();
+        auto layer = std::make_unique<LayerComponent>();
+        layer->Layer = i;
+        entity->AttachComponent(std::move(layer));
+        ids.push_back(manager.AddEntity(std::move(entity)));
+        if (i % 2 == 0)
+            removedIds.push_back(ids.back());
+    }
+
+    // Entities removed before systems heard of them are never offered to systems
+    std::vector<std::unique_ptr<Exi::ECS::Entity>> removed;
+    if (manager.RemoveEntities(removedIds, removed) != removedIds.size())
+        return false;
+    manager.TickSystems(0);
+
+    const auto& entities = group.GetEntities();
+    if (entities.size() != ids.size() - removedIds.size())
+        return false;
+    for (const auto* entity : entities)
+    {
+        if (entity->GetComponent<LayerComponent>()->Layer % 2 != 1)
+            return false;
+    }
+
+    // The rest were merged, so removing them notifies the system
+    const std::size_t remaining = entities.size();
+    removed.clear();
+    manager.RemoveEntities(ids, removed);
+    manager.TickSystems(0);
+    return removed.size() == remaining && group.GetEntities().empty();
+}
+
+bool Test_EntityManagerDuplicateId()
+{
+    Exi::ECS::EntityManager manager;
+    const auto taken = manager.AddEntity(std::make_unique<Exi::ECS::Entity>("First"));
+
+    std::vector<std::unique_ptr<Exi::ECS::Entity>> entities;
+    entities.push_back(std::make_unique<Exi::ECS::Entity>("Duplicate"));
+    entities.push_back(std::make_unique<Exi::ECS::Entity>("Fresh"));
+    const Exi::ECS::EntityManager::EntityId ids[] = { taken, Exi::TL::UUID::V4() };
+    Exi::ECS::EntityManager::EntityId idsOut[2];
+
+    // The duplicate is handed back untouched instead of being destroyed
+    const auto* duplicate = entities[0].get();
+    const auto originalId = duplicate->GetUniqueId();
+    if (manager.AddEntities(entities, ids, idsOut) != 1 || entities.size() != 1 || entities[0].get() != duplicate)
+        return false;
+
+    return duplicate->GetUniqueId() == originalId &&
+        idsOut[0] == Exi::ECS::EntityManager::InvalidId && idsOut[1] == ids[1] &&
+        manager.GetEntity(taken)->GetName() == "First" && manager.GetEntity(ids[1])->GetName() == "Fresh";
+}
+
+bool Test_EntityManagerMemoryStats()
+{
+    Exi::ECS::EntityManager manager;
+    for (int i = 0; i < 10; i++)
+    {
+        auto entity = std::make_unique<Exi::ECS::Entity>(i == 0 ? "An entity name too long for small strings" : "");
+        entity->AttachComponent(std::make_unique<PositionComponent>());
+        if (i < 3)
+            entity->AttachComponent(std::make_unique<HealthComponent>());
+        manager.AddEntity(std::move(entity));
+    }
+    manager.PushEvent(DamageEvent { 1, 2 });
+
+    const auto stats = manager.CollectMemoryStats();
+    stats.Dump(Exi::Runtime::Logger::GetLogger("ECS"));
+    const auto* position = stats.GetComponent(PositionComponent::Static::Id);
+    const auto* health = stats.GetComponent(HealthComponent::Static::Id);
+
+    return stats.EntityCount == 10 && stats.EntityBytes == 10 * sizeof(Exi::ECS::Entity) &&
+        position && position->Count == 10 && position->Bytes == 10 * sizeof(PositionComponent) &&
+        health && health->Count == 3 && health->Bytes == 3 * sizeof(HealthComponent) &&
+        stats.Components.front().Bytes >= stats.Components.back().Bytes &&
+        stats.NameBytes > 0 && stats.ComponentMapBytes > 0 && stats.StorageBytes > 0 && stats.EventBytes > 0;
+}
+
+DeriveClass(TickCountingSystem, Exi::ECS::System)
+{
+public:
+    void Tick(double deltaTime) override
+    {
+        Ticks++;
+        Time += deltaTime;
+    }
+
+    int Ticks = 0;
+    double Time = 0;
+};
+
+bool Test_SessionReplay()
+{
+    constexpr std::uint32_t spawnCommand = 1;
+    Exi::Runtime::Filesystem fs;
+    std::vector<Exi::ECS::EntityManager::EntityId> recorded, replayed;
+
+    auto spawn = [](Exi::ECS::EntityManager& manager, int health) {
+        auto entity = std::make_unique<Exi::ECS::Entity>();
+        auto component = std::make_unique<HealthComponent>();
+        component->Health = health;
+        entity->AttachComponent(std::move(component));
+        return manager.AddEntity(std::move(entity));
+    };
+
+    {
+        // The manager and this thread's ID range were already in use before the session started
+        Exi::ECS::EntityManager manager;
+        spawn(manager, -1);
+        Exi::ECS::SessionRecorder recorder(fs, "Session.bin", manager, 0x1234);
+        if (!recorder.IsOpen())
+            return false;
+
+        for (int tick = 0; tick < 100; tick++)
+        {
+            if (tick % 3 == 0)
+            {
+                recorder.RecordCommand(spawnCommand, tick);
+                recorded.push_back(spawn(manager, tick));
+            }
+            recorder.Tick(manager, 1.0 / (60 + tick));
+        }
+    }
+
+    // Replayed on another thread, into a manager created before the player
+    Exi::ECS::EntityManager manager;
+    Exi::ECS::SessionPlayer player(fs, "Session.bin");
+    TickCountingSystem system;
+    manager.RegisterSystem(&system);
+
+    player.SetCommandHandler([&](std::uint32_t type, std::span<const std::uint8_t> data) {
+        int health;
+        if (type == spawnCommand && data.size() == sizeof(health))
+        {
+            std::memcpy(&health, data.data(), sizeof(health));
+            replayed.push_back(spawn(manager, health));
+        }
+    });
+
+    double expectedTime = 0;
+    for (int tick = 0; tick < 100; tick++)
+        expectedTime += 1.0 / (60 + tick);
+
+    // Same ID state, same inputs: the replay creates entities with the same IDs
+    std::size_t ticks = 0;
+    std::thread([&] { ticks = player.Run(manager); }).join();
+    return player.IsValid() && ticks == 100 && player.IsFinished() &&
+        system.Ticks == 100 && system.Time == expectedTime &&
+        replayed == recorded && manager.GetEntity(replayed.back())->GetComponent<HealthComponent>()->Health == 99;
+}
+
+DefineComponent(ClockComponent)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class)
+    {
+        ExposeField(Class, Time);
+    }
+
+    double Time = 0;
+};
+
+DefineComponent(SpriteSheetComponent)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class) { }
+
+    ~SpriteSheetComponent() override { Destroyed++; }
+
+    static inline int Destroyed = 0;
+    char Pixels[4096] = { };
+};
+
+bool Test_SingletonAndSharedComponents()
+{
+    Exi::ECS::EntityManager manager;
+    if (manager.GetSingleton<ClockComponent>() != nullptr)
+        return false;
+
+    manager.SetSingleton(std::make_unique<ClockComponent>()).Time = 1.0;
+    manager.GetSingleton<ClockComponent>()->Time += 1.0;
+    if (manager.GetSingleton<ClockComponent>()->Time != 2.0)
+        return false;
+
+    auto* sheet = manager.CreateSharedComponent<SpriteSheetComponent>();
+    std::vector<Exi::ECS::EntityManager::EntityId> ids;
+    for (int i = 0; i < 100; i++)
+    {
+        auto entity = std::make_unique<Exi::ECS::Entity>();
+        entity->AttachComponent(std::make_unique<PositionComponent>());
+        entity->AttachSharedComponent(sheet);
+        ids.push_back(manager.AddEntity(std::move(entity)));
+    }
+
+    // Shared components are found and counted like the entity's own
+    std::vector<SpriteSheetComponent*> found;
+    for (const auto& id : ids)
+    {
+        const auto* entity = manager.GetEntity(id);
+        if (entity->GetComponent<SpriteSheetComponent>() != sheet || entity->GetComponentCount<SpriteSheetComponent>() != 1 ||
+            entity->GetComponentsOfType(found) != 1 || found[0] != sheet)
+            return false;
+    }
+
+    // The sheet is stored once however many entities reference it
+    const auto stats = manager.CollectMemoryStats();
+    const auto* sheets = stats.GetComponent(SpriteSheetComponent::Static::Id);
+    const auto* clocks = stats.GetComponent(ClockComponent::Static::Id);
+    if (!sheets || sheets->Count != 1 || !clocks || clocks->Count != 1)
+        return false;
+
+    // Removing entities leaves the shared component alive, only its manager destroys it
+    std::vector<std::unique_ptr<Exi::ECS::Entity>> removed;
+    manager.RemoveEntities(ids, removed);
+    removed.clear();
+    if (SpriteSheetComponent::Destroyed != 0)
+        return false;
+    {
+        Exi::ECS::EntityManager other;
+        other.CreateSharedComponent<SpriteSheetComponent>();
+    }
+    return SpriteSheetComponent::Destroyed == 1;
+}
+
+bool Test_EntityManagerFindEntity()
+{
+    Exi::ECS::EntityManager manager;
+    manager.AddEntity(std::make_unique<Exi::ECS::Entity>("Boss"));
+    for (int i = 0; i < 32; i++)
+        manager.AddEntity(std::make_unique<Exi::ECS::Entity>("Minion"));
+
+    // Entities added before the index was enabled are indexed too
+    manager.SetNameIndexEnabled(true);
+    const auto lateId = manager.AddEntity(std::make_unique<Exi::ECS::Entity>("Minion"));
+
+    std::vector<const Exi::ECS::Entity*> minions;
+    const auto* boss = manager.FindEntity("Boss");
+    if (!boss || boss->GetName() != "Boss" || manager.FindEntity("Nobody") != nullptr ||
+        manager.FindEntities("Minion", minions) != 33)
+        return false;
+
+    std::vector<std::unique_ptr<Exi::ECS::Entity>> removed;
+    const Exi::ECS::EntityManager::EntityId ids[] = { boss->GetUniqueId(), lateId };
+    manager.RemoveEntities(ids, removed);
+
+    minions.clear();
+    return manager.FindEntity("Boss") == nullptr && manager.FindEntities("Minion", minions) == 32 &&
+        removed[0]->GetNameId() == Exi::TL::NameTable::GetGlobal().Find("Boss");
+}
+
 int main(int argc, const char** argv)
 {
     const Exi::Unit::Tests tests({
@@ -81,7 +822,24 @@ int main(int argc, const char** argv)
         { "ComponentConstruction", Test_ComponentConstruction },
         { "EntityConstruction", Test_EntityConstruction },
         { "EntityComponentSearch", Test_EntityComponentSearch },
-        { "EntityManagerGetEntity", Test_EntityManagerGetEntity }
+        { "EntityDerivedComponentSearch", Test_EntityDerivedComponentSearch },
+        { "EntityDetachComponent", Test_EntityDetachComponent },
+        { "EntityManagerGetEntity", Test_EntityManagerGetEntity },
+        { "EntityIdOrder", Test_EntityIdOrder },
+        { "EntityManagerConcurrentAdd", Test_EntityManagerConcurrentAdd },
+        { "EntityManagerRegisterDuringAdd", Test_EntityManagerRegisterDuringAdd },
+        { "EntityManagerDuplicateId", Test_EntityManagerDuplicateId },
+        { "EntityManagerRemovePending", Test_EntityManagerRemovePending },
+        { "EntityManagerMemoryStats", Test_EntityManagerMemoryStats },
+        { "EntityManagerFindEntity", Test_EntityManagerFindEntity },
+        { "EventChannel", Test_EventChannel },
+        { "InterestManager", Test_InterestManager },
+        { "RegionSerializer", Test_RegionSerializer },
+        { "RegionStreamer", Test_RegionStreamer },
+        { "RegionStreamer_Reload", Test_RegionStreamer_Reload },
+        { "SessionReplay", Test_SessionReplay },
+        { "SingletonAndSharedComponents", Test_SingletonAndSharedComponents },
+        { "SortedGroup", Test_SortedGroup }
     });
 
     return tests.Execute(argc, argv);
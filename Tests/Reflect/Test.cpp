@@ -91,13 +91,47 @@ bool Test_FieldSet()
     return true;
 }
 
+DeriveClass(OtherDerivedTestClass, TestClass)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class) { }
+};
+
+DefineClass(UnrelatedTestClass)
+{
+public:
+    static void StaticInitialize(Exi::Reflect::Class& Class) { }
+};
+
+bool Test_IsA()
+{
+    auto* Registry = Exi::Reflect::ClassRegistry::GetInstance();
+    auto* Base    = Registry->GetClass<TestClass>();
+    auto* Derived = Registry->GetClass<DerivedTestClass>();
+    auto* Other   = Registry->GetClass<OtherDerivedTestClass>();
+    auto* Unrelated = Registry->GetClass<UnrelatedTestClass>();
+
+    if (!Derived->IsA(*Base) || !Other->IsA(*Base) || !Base->IsA(*Base))
+        return false;
+    if (Base->IsA(*Derived) || Derived->IsA(*Other) || Unrelated->IsA(*Base))
+        return false;
+
+    auto classes = Registry->GetDerivedClasses(TestClass::Static::Id);
+    if (classes.size() != 3 || classes.front() != TestClass::Static::Id)
+        return false;
+
+    return Registry->IsA(DerivedTestClass::Static::Id, TestClass::Static::Id) &&
+        !Registry->IsA(UnrelatedTestClass::Static::Id, TestClass::Static::Id);
+}
+
 int main(int argc, const char** argv)
 {
     const Exi::Unit::Tests tests ({
         { "Benchmark", Benchmark },
         { "StaticInitialize", Test_StaticInitialize },
         { "FieldGet", Test_FieldGet },
-        { "FieldSet", Test_FieldSet }
+        { "FieldSet", Test_FieldSet },
+        { "IsA", Test_IsA }
     });
 
     return tests.Execute(argc, argv);
@@ -1,6 +1,7 @@
 #include <Exile/Unit/Benchmark.hpp>
 #include <Exile/Runtime/Filesystem.hpp>
 #include <filesystem>
+#include <vector>
 
 Exi::Unit::BenchmarkResults Benchmark_Filesystem_TranslatePath()
 {
@@ -34,10 +35,33 @@ Exi::Unit::BenchmarkResults Benchmark_Path_Constructor()
     return BENCHMARK_END(Path_Constructor);
 }
 
+/**
+ * Split a typical path into fragments
+ * @tparam Fragments std::vector or PathUtils::Fragments
+ */
+template <class Fragments>
+Exi::Unit::BenchmarkResults Benchmark_PathUtils_SplitPath()
+{
+    const std::string path = "Assets/Textures/Terrain/Grass/albedo.png";
+    BENCHMARK_START(PathUtils_SplitPath, 1 << 20);
+    BENCHMARK_LOOP(PathUtils_SplitPath)
+    {
+        Fragments fragments;
+        if (Exi::Runtime::PathUtils::SplitPath(path, fragments) != 5)
+        {
+            BENCHMARK_FAIL(PathUtils_SplitPath);
+            break;
+        }
+    }
+    return BENCHMARK_END(PathUtils_SplitPath);
+}
+
 bool Benchmark()
 {
     Exi::Unit::RunBenchmark("Filesystem::TranslatePath", Benchmark_Filesystem_TranslatePath);
     Exi::Unit::RunBenchmark("Path::Path", Benchmark_Path_Constructor);
+    Exi::Unit::RunBenchmark("PathUtils::SplitPath (std::vector)", Benchmark_PathUtils_SplitPath<std::vector<std::string_view>>);
+    Exi::Unit::RunBenchmark("PathUtils::SplitPath (Fragments)", Benchmark_PathUtils_SplitPath<Exi::Runtime::PathUtils::Fragments>);
 
     return true;
 }
@@ -47,6 +47,24 @@ bool Test_PathUtils_GetNextFragment()
     return true;
 }
 
+bool Test_PathUtils_SplitPath()
+{
+    const std::string path = "/\\a////b\\/c/";
+    Exi::Runtime::PathUtils::Fragments fragments;
+    if (Exi::Runtime::PathUtils::SplitPath(path, fragments) != 3 || !fragments.IsInline())
+        return false;
+
+    if (fragments[0] != "a" || fragments[1] != "b" || fragments[2] != "c")
+        return false;
+
+    // More fragments than fit inline
+    std::string deep;
+    for (int i = 0; i < 40; i++)
+        deep += "/d";
+    fragments.clear();
+    return Exi::Runtime::PathUtils::SplitPath(deep, fragments) == 40 && fragments.back() == "d";
+}
+
 bool Test_PathUtils_StripSeparators()
 {
     std::string test1 = "\\\\test1";
@@ -266,6 +284,7 @@ int main(int argc, const char** argv)
         { "LuaContext_ExecuteString", Test_LuaContext_ExecuteString },
         { "LuaContext_SetGlobalFunction", Test_LuaContext_SetGlobalFunction },
         { "PathUtils_GetNextFragment", Test_PathUtils_GetNextFragment },
+        { "PathUtils_SplitPath", Test_PathUtils_SplitPath },
         { "PathUtils_StripSeparators", Test_PathUtils_StripSeparators },
         { "Path_Constructor", Test_Path_Constructor },
         { "Path_GetFile", Test_Path_GetFile },
@@ -1,7 +1,29 @@
 #include <cstdio>
 #include <Exile/Unit/Benchmark.hpp>
 #include <Exile/TL/NumericMap.hpp>
+#include <Exile/TL/LRUCache.hpp>
+#include <Exile/TL/ShardedCache.hpp>
 #include <Exile/TL/FreeMap.hpp>
+#include <Exile/TL/AtomicFreeMap.hpp>
+#include <Exile/TL/ObjectPool.hpp>
+#include <Exile/TL/ConcurrentObjectPool.hpp>
+#include <Exile/TL/PoolAllocator.hpp>
+#include <Exile/TL/SpscRing.hpp>
+#include <Exile/TL/MpmcQueue.hpp>
+#include <Exile/TL/SmallVector.hpp>
+#include <Exile/TL/UUID.hpp>
+#include <algorithm>
+#include <barrier>
+#include <unordered_map>
+#include <bit>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LegacyNumericMap.hpp"
 
 Exi::Unit::BenchmarkResults Benchmark_NumericMap_Find()
 {
@@ -54,6 +76,267 @@ Exi::Unit::BenchmarkResults Benchmark_NumericMap_GetKeys()
     return BENCHMARK_END(NumericMap_GetKeys);
 }
 
+static constexpr std::size_t NumericMapKey(std::size_t i)
+{
+    return i * 0x9E3779B97F4A7C15ULL;
+}
+
+template <class Map, std::size_t Keys>
+Exi::Unit::BenchmarkResults Benchmark_NumericMap_EmplaceKeys()
+{
+    // The map is rebuilt every `Keys` insertions, so every size inserts the same total
+    std::optional<Map> map;
+
+    BENCHMARK_START(NumericMap_EmplaceKeys, (65536 * 16 + Keys - 1) / Keys * Keys);
+    BENCHMARK_LOOP(NumericMap_EmplaceKeys)
+    {
+        const std::size_t i = Iteration % Keys;
+        if (i == 0)
+            map.emplace();
+        map->Emplace(NumericMapKey(i), static_cast<int>(i));
+    }
+    if (map->GetKeys() != Keys)
+        BENCHMARK_FAIL(NumericMap_EmplaceKeys);
+    return BENCHMARK_END(NumericMap_EmplaceKeys);
+}
+
+template <class Map, std::size_t Keys>
+Exi::Unit::BenchmarkResults Benchmark_NumericMap_FindKeys()
+{
+    Map map;
+    int value;
+
+    for (std::size_t i = 0; i < Keys; i++)
+        map.Emplace(NumericMapKey(i), static_cast<int>(i));
+
+    BENCHMARK_START(NumericMap_FindKeys, 65536 * 16);
+    BENCHMARK_LOOP(NumericMap_FindKeys)
+    {
+        const std::size_t i = Iteration % Keys;
+        if (map.Find(NumericMapKey(i), &value, 1) != 1 || value != static_cast<int>(i))
+        {
+            BENCHMARK_FAIL(NumericMap_FindKeys);
+            break;
+        }
+    }
+    return BENCHMARK_END(NumericMap_FindKeys);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_NumericMap_EmplaceErase()
+{
+    Exi::TL::NumericMap<std::size_t, int> map;
+    for (std::size_t i = 0; i < 1000; i++)
+        map.Emplace(NumericMapKey(i), static_cast<int>(i));
+
+    // Keeps 1k keys live, replacing the oldest key every iteration
+    BENCHMARK_START(NumericMap_EmplaceErase, 65536 * 16);
+    BENCHMARK_LOOP(NumericMap_EmplaceErase)
+    {
+        map.Emplace(NumericMapKey(Iteration + 1000), static_cast<int>(Iteration));
+        if (map.Erase(NumericMapKey(Iteration)) != 1)
+        {
+            BENCHMARK_FAIL(NumericMap_EmplaceErase);
+            break;
+        }
+    }
+    return BENCHMARK_END(NumericMap_EmplaceErase);
+}
+
+struct PoolObject
+{
+    std::size_t Values[4];
+};
+
+Exi::Unit::BenchmarkResults Benchmark_LRUCache_Hit()
+{
+    // A full cache hit in least recently used order, the old deque's worst case
+    constexpr std::size_t capacity = 1024;
+    Exi::TL::LRUCache<std::string, std::size_t> cache(capacity);
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < capacity; i++)
+    {
+        keys.push_back("/assets/textures/" + std::to_string(i) + ".png");
+        cache.Put(keys.back(), i);
+    }
+
+    BENCHMARK_START(LRUCache_Hit, 65536 * 16);
+    BENCHMARK_LOOP(LRUCache_Hit)
+    {
+        const std::string_view key = keys[Iteration % capacity];
+        const std::size_t* value = cache.TryGet(key);
+        if (!value || *value != Iteration % capacity)
+        {
+            BENCHMARK_FAIL(LRUCache_Hit);
+            break;
+        }
+    }
+    return BENCHMARK_END(LRUCache_Hit);
+}
+
+/**
+ * LRUCache guarded by a single mutex, what ShardedCache replaces
+ */
+template <class K, class V>
+class LockedLRUCache
+{
+public:
+    explicit LockedLRUCache(std::size_t capacity) : m_Cache(capacity) { }
+
+    bool TryGet(const K& key, V& value)
+    {
+        std::unique_lock lock(m_Mutex);
+        const V* cached = m_Cache.TryGet(key);
+        if (cached)
+            value = *cached;
+        return cached;
+    }
+
+    void Put(const K& key, V value)
+    {
+        std::unique_lock lock(m_Mutex);
+        m_Cache.Put(key, std::move(value));
+    }
+private:
+    std::mutex m_Mutex;
+    Exi::TL::LRUCache<K, V> m_Cache;
+};
+
+template <class Cache, int Threads>
+Exi::Unit::BenchmarkResults Benchmark_Cache_Threads()
+{
+    // Mostly hits, every thread walking the same 1024 keys from a different offset
+    constexpr std::size_t keys = 1024;
+    constexpr std::size_t perThread = 65536 * 16 / Threads;
+    Cache cache(keys * 2);
+    for (std::size_t i = 0; i < keys; i++)
+        cache.Put(i, i);
+    std::atomic_bool failed = false;
+
+    std::vector<std::thread> workers;
+    BENCHMARK_START(Cache_Threads, perThread * Threads);
+    for (int t = 0; t < Threads; t++)
+    {
+        workers.emplace_back([&, t] {
+            for (std::size_t i = 0; i < perThread; i++)
+            {
+                const std::size_t key = (i + t * 97) % keys;
+                std::size_t value;
+                if (!cache.TryGet(key, value) || value != key)
+                    failed = true;
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    if (failed)
+        BENCHMARK_FAIL(Cache_Threads);
+    return BENCHMARK_END(Cache_Threads);
+}
+
+template <std::size_t Live, Exi::TL::PoolBacking Backing = Exi::TL::PoolBacking::Heap>
+Exi::Unit::BenchmarkResults Benchmark_ObjectPool_GetRelease()
+{
+    Exi::TL::ObjectPool<PoolObject> pool(Backing);
+    std::vector<PoolObject*> objects(Live);
+    for (auto& object : objects)
+        object = pool.Get();
+
+    // Replace live objects in a scattered order, so releases hit blocks all over the pool
+    BENCHMARK_START(ObjectPool_GetRelease, 65536 * 16);
+    BENCHMARK_LOOP(ObjectPool_GetRelease)
+    {
+        auto& object = objects[(Iteration * 7919) % Live];
+        if (!pool.Release(object))
+        {
+            BENCHMARK_FAIL(ObjectPool_GetRelease);
+            break;
+        }
+        object = pool.Get();
+    }
+    return BENCHMARK_END(ObjectPool_GetRelease);
+}
+
+template <class Allocator>
+Exi::Unit::BenchmarkResults Benchmark_ListChurn()
+{
+    std::list<PoolObject, Allocator> list(1000);
+
+    BENCHMARK_START(ListChurn, 65536 * 16);
+    BENCHMARK_LOOP(ListChurn)
+    {
+        list.push_back({ Iteration });
+        list.pop_front();
+    }
+    if (list.size() != 1000)
+        BENCHMARK_FAIL(ListChurn);
+    return BENCHMARK_END(ListChurn);
+}
+
+/**
+ * Pool guarded by a single mutex, what ConcurrentObjectPool replaces
+ */
+template <class T>
+class LockedObjectPool
+{
+public:
+    T* Get()
+    {
+        std::unique_lock lock(m_Mutex);
+        return m_Pool.Get();
+    }
+
+    bool Release(T* ptr)
+    {
+        std::unique_lock lock(m_Mutex);
+        return m_Pool.Release(ptr);
+    }
+private:
+    std::mutex m_Mutex;
+    Exi::TL::ObjectPool<T> m_Pool;
+};
+
+template <class Pool, int Threads>
+Exi::Unit::BenchmarkResults Benchmark_ObjectPool_CrossThread()
+{
+    // Each round every thread gets a batch, then releases the batch of the thread before it
+    constexpr std::size_t batch = 256;
+    constexpr std::size_t rounds = 65536 * 16 / batch / Threads;
+    Pool pool;
+    std::vector<PoolObject*> batches[Threads];
+    std::barrier sync(Threads);
+    std::atomic_bool failed = false;
+
+    std::vector<std::thread> workers;
+    BENCHMARK_START(ObjectPool_CrossThread, rounds * batch * Threads);
+    for (int t = 0; t < Threads; t++)
+    {
+        workers.emplace_back([&, t] {
+            auto& own = batches[t];
+            auto& other = batches[(t + Threads - 1) % Threads];
+            own.resize(batch);
+            for (std::size_t round = 0; round < rounds; round++)
+            {
+                for (auto& object : own)
+                    object = pool.Get();
+                sync.arrive_and_wait();
+                for (auto* object : other)
+                {
+                    if (!pool.Release(object))
+                        failed = true;
+                }
+                sync.arrive_and_wait();
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    if (failed)
+        BENCHMARK_FAIL(ObjectPool_CrossThread);
+    return BENCHMARK_END(ObjectPool_CrossThread);
+}
+
 Exi::Unit::BenchmarkResults Benchmark_FreeMap_Allocate()
 {
     constexpr std::size_t count = 8;
@@ -73,11 +356,524 @@ Exi::Unit::BenchmarkResults Benchmark_FreeMap_Allocate()
     return BENCHMARK_END(FreeMap_Allocate);
 }
 
+Exi::Unit::BenchmarkResults Benchmark_FreeMap_AllocateFull()
+{
+    // 1M bits with only the last one free before each allocation
+    using Map = Exi::TL::FreeMap<1 << 20>;
+    auto map = std::make_unique<Map>();
+    for (int i = 0; i < (1 << 20); i++)
+        map->Allocate();
+
+    BENCHMARK_START(FreeMap_AllocateFull, 65536 * 16);
+    BENCHMARK_LOOP(FreeMap_AllocateFull)
+    {
+        map->Free((1 << 20) - 1);
+        if (map->Allocate() != (1 << 20) - 1)
+        {
+            BENCHMARK_FAIL(FreeMap_AllocateFull);
+            break;
+        }
+    }
+    return BENCHMARK_END(FreeMap_AllocateFull);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_FreeMap_AllocateRange()
+{
+    Exi::TL::FreeMap<65536> map;
+
+    BENCHMARK_START(FreeMap_AllocateRange, 65536 * 16);
+    BENCHMARK_LOOP(FreeMap_AllocateRange)
+    {
+        auto index = map.AllocateRange(100);
+        if (index == Exi::TL::FreeMap<65536>::InvalidIndex)
+        {
+            map.FreeAll();
+            index = map.AllocateRange(100);
+        }
+        if (index == Exi::TL::FreeMap<65536>::InvalidIndex)
+        {
+            BENCHMARK_FAIL(FreeMap_AllocateRange);
+            break;
+        }
+    }
+    return BENCHMARK_END(FreeMap_AllocateRange);
+}
+
+/**
+ * FreeMap guarded by a single mutex, what AtomicFreeMap replaces
+ */
+template <int N>
+class LockedFreeMap
+{
+public:
+    static constexpr std::size_t InvalidIndex = Exi::TL::FreeMap<N>::InvalidIndex;
+
+    std::size_t Allocate()
+    {
+        std::unique_lock lock(m_Mutex);
+        return m_Map.Allocate();
+    }
+
+    bool Free(std::size_t i)
+    {
+        std::unique_lock lock(m_Mutex);
+        m_Map.Free(i);
+        return true;
+    }
+private:
+    std::mutex m_Mutex;
+    Exi::TL::FreeMap<N> m_Map;
+};
+
+template <class Map, int Threads>
+Exi::Unit::BenchmarkResults Benchmark_FreeMap_Contention()
+{
+    // Every thread keeps a few handles live and keeps swapping them for new ones
+    constexpr std::size_t held = 16;
+    constexpr std::size_t perThread = 65536 * 16 / Threads;
+    Map map;
+    std::atomic_bool failed = false;
+
+    std::vector<std::thread> workers;
+    BENCHMARK_START(FreeMap_Contention, perThread * Threads);
+    for (int t = 0; t < Threads; t++)
+    {
+        workers.emplace_back([&] {
+            std::size_t handles[held];
+            for (auto& handle : handles)
+                handle = map.Allocate();
+            for (std::size_t i = 0; i < perThread; i++)
+            {
+                auto& handle = handles[i % held];
+                map.Free(handle);
+                handle = map.Allocate();
+                if (handle == Map::InvalidIndex)
+                    failed = true;
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    if (failed)
+        BENCHMARK_FAIL(FreeMap_Contention);
+    return BENCHMARK_END(FreeMap_Contention);
+}
+
+template <Exi::TL::UUID (*Generate)(), int Threads>
+Exi::Unit::BenchmarkResults Benchmark_UUID_Random()
+{
+    constexpr std::size_t perThread = 65536 * 16 / Threads;
+    std::atomic_bool failed = false;
+
+    std::vector<std::thread> workers;
+    BENCHMARK_START(UUID_Random, perThread * Threads);
+    for (int t = 0; t < Threads; t++)
+    {
+        workers.emplace_back([&] {
+            // Compare neighbours so the generation isn't optimized out
+            Exi::TL::UUID last = Generate();
+            for (std::size_t i = 0; i < perThread; i++)
+            {
+                const Exi::TL::UUID uuid = Generate();
+                if (uuid == last)
+                    failed = true;
+                last = uuid;
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    if (failed)
+        BENCHMARK_FAIL(UUID_Random);
+    return BENCHMARK_END(UUID_Random);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_UUID_Sort()
+{
+    constexpr std::size_t count = 65536;
+    std::vector<Exi::TL::UUID> uuids(count);
+    for (auto& uuid : uuids)
+        uuid = Exi::TL::UUID::Random();
+
+    BENCHMARK_START(UUID_Sort, count);
+    std::sort(uuids.begin(), uuids.end());
+    if (!std::is_sorted(uuids.begin(), uuids.end()))
+        BENCHMARK_FAIL(UUID_Sort);
+    return BENCHMARK_END(UUID_Sort);
+}
+
+/**
+ * std::hash<UUID> before it mixed both halves, kept to compare against
+ */
+struct LegacyUUIDHash
+{
+    std::size_t operator()(const Exi::TL::UUID& k) const
+    {
+        std::size_t h = ~0;
+        for (int i = 0; i < 16; i++)
+        {
+            h <<= 4;
+            h ^= std::hash<uint8_t>()(k.bytes[i]);
+        }
+        return h;
+    }
+};
+
+template <class Hash>
+Exi::Unit::BenchmarkResults Benchmark_UUID_Find()
+{
+    // Entity-style IDs: one prefix, sequential counters
+    constexpr std::size_t count = 100000;
+    std::unordered_map<Exi::TL::UUID, std::size_t, Hash> map;
+    std::vector<Exi::TL::UUID> ids;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        ids.emplace_back(0x12345678, 0x9ABC, 0xDEF0, std::rotl(uint64_t(i), 16));
+        map.emplace(ids.back(), i);
+    }
+
+    BENCHMARK_START(UUID_Find, 65536 * 16);
+    BENCHMARK_LOOP(UUID_Find)
+    {
+        const std::size_t i = (Iteration * 7919) % count;
+        auto it = map.find(ids[i]);
+        if (it == map.end() || it->second != i)
+        {
+            BENCHMARK_FAIL(UUID_Find);
+            break;
+        }
+    }
+    return BENCHMARK_END(UUID_Find);
+}
+
+/** Formats the way UUID::ToString did before it had its own formatter */
+static void FormatUUIDSnprintf(const Exi::TL::UUID& uuid, char* buffer)
+{
+    snprintf(buffer, 39, "{%08X-%04X-%04X-%04llX-%012llX}", uuid.a, uuid.b, uuid.c,
+             static_cast<unsigned long long>(uuid.d & 0xFFFF), static_cast<unsigned long long>(uuid.d >> 16));
+}
+
+template <bool Snprintf>
+Exi::Unit::BenchmarkResults Benchmark_UUID_Format()
+{
+    constexpr std::size_t count = 1024;
+    std::vector<Exi::TL::UUID> uuids(count);
+    for (auto& uuid : uuids)
+        uuid = Exi::TL::UUID::Random();
+    char buffer[39];
+    std::size_t check = 0;
+
+    BENCHMARK_START(UUID_Format, 65536 * 16);
+    BENCHMARK_LOOP(UUID_Format)
+    {
+        if constexpr (Snprintf)
+            FormatUUIDSnprintf(uuids[Iteration % count], buffer);
+        else
+            uuids[Iteration % count].ToString(buffer);
+        check += buffer[1 + Iteration % 36];
+    }
+    if (check == 0)
+        BENCHMARK_FAIL(UUID_Format);
+    return BENCHMARK_END(UUID_Format);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_UUID_FormatBatch()
+{
+    constexpr std::size_t count = 1024;
+    std::vector<Exi::TL::UUID> uuids(count);
+    for (auto& uuid : uuids)
+        uuid = Exi::TL::UUID::Random();
+    std::string text(count * Exi::TL::UUID::StringLength, ' ');
+
+    BENCHMARK_START(UUID_FormatBatch, 1024 * count);
+    for (std::size_t i = 0; i < 1024; i++)
+        Exi::TL::UUID::Format(uuids.data(), count, text.data());
+    if (text[0] != '{')
+        BENCHMARK_FAIL(UUID_FormatBatch);
+    return BENCHMARK_END(UUID_FormatBatch);
+}
+
+Exi::Unit::BenchmarkResults Benchmark_UUID_ParseBatch()
+{
+    constexpr std::size_t count = 1024;
+    std::vector<Exi::TL::UUID> uuids(count), parsed(count);
+    for (auto& uuid : uuids)
+        uuid = Exi::TL::UUID::Random();
+    std::string text(count * Exi::TL::UUID::StringLength, ' ');
+    Exi::TL::UUID::Format(uuids.data(), count, text.data());
+
+    BENCHMARK_START(UUID_ParseBatch, 1024 * count);
+    for (std::size_t i = 0; i < 1024; i++)
+    {
+        if (Exi::TL::UUID::Parse(text.data(), count, parsed.data()) != count)
+        {
+            BENCHMARK_FAIL(UUID_ParseBatch);
+            break;
+        }
+    }
+    if (parsed != uuids)
+        BENCHMARK_FAIL(UUID_ParseBatch);
+    return BENCHMARK_END(UUID_ParseBatch);
+}
+
+/**
+ * Deque guarded by a single mutex, the usual queue before MpmcQueue
+ */
+template <class T>
+class LockedQueue
+{
+public:
+    explicit LockedQueue(std::size_t capacity) : m_Capacity(capacity) { }
+
+    template <class It>
+    std::size_t TryPushBatch(It first, std::size_t count)
+    {
+        std::unique_lock lock(m_Mutex);
+        count = std::min(count, m_Capacity - m_Queue.size());
+        for (std::size_t i = 0; i < count; i++, ++first)
+            m_Queue.push_back(*first);
+        return count;
+    }
+
+    template <class It>
+    std::size_t TryPopBatch(It out, std::size_t count)
+    {
+        std::unique_lock lock(m_Mutex);
+        count = std::min(count, m_Queue.size());
+        for (std::size_t i = 0; i < count; i++, ++out)
+        {
+            *out = m_Queue.front();
+            m_Queue.pop_front();
+        }
+        return count;
+    }
+private:
+    std::mutex m_Mutex;
+    std::deque<T> m_Queue;
+    std::size_t m_Capacity;
+};
+
+/**
+ * Move items from producers to consumers through a queue, each side moving `Batch` items per call
+ * @tparam Queue
+ * @tparam Producers
+ * @tparam Consumers
+ * @tparam Batch
+ */
+template <class Queue, int Producers, int Consumers, std::size_t Batch>
+Exi::Unit::BenchmarkResults Benchmark_Queue_Throughput()
+{
+    constexpr std::size_t perProducer = 65536 * 16 / Producers;
+    constexpr std::size_t total = perProducer * Producers;
+    Queue queue(4096);
+    std::atomic<std::size_t> consumed = 0, sum = 0;
+
+    std::vector<std::thread> workers;
+    BENCHMARK_START(Queue_Throughput, total);
+    for (int p = 0; p < Producers; p++)
+    {
+        workers.emplace_back([&] {
+            std::size_t items[Batch];
+            for (std::size_t next = 0; next < perProducer; )
+            {
+                const std::size_t size = std::min(Batch, perProducer - next);
+                for (std::size_t i = 0; i < size; i++)
+                    items[i] = next + i;
+                const std::size_t pushed = queue.TryPushBatch(items, size);
+                if (!pushed)
+                    std::this_thread::yield();
+                next += pushed;
+            }
+        });
+    }
+    for (int c = 0; c < Consumers; c++)
+    {
+        workers.emplace_back([&] {
+            std::size_t items[Batch], local = 0;
+            while (consumed.load(std::memory_order_relaxed) < total)
+            {
+                const std::size_t popped = queue.TryPopBatch(items, Batch);
+                if (!popped)
+                    std::this_thread::yield();
+                for (std::size_t i = 0; i < popped; i++)
+                    local += items[i];
+                consumed += popped;
+            }
+            sum += local;
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    if (sum != Producers * (perProducer * (perProducer - 1) / 2))
+        BENCHMARK_FAIL(Queue_Throughput);
+    return BENCHMARK_END(Queue_Throughput);
+}
+
+/**
+ * Bounce one item between two threads through a pair of queues, measuring the round trip
+ * @tparam Queue
+ */
+template <class Queue>
+Exi::Unit::BenchmarkResults Benchmark_Queue_RoundTrip()
+{
+    constexpr std::size_t trips = 65536;
+    Queue ping(64), pong(64);
+
+    std::thread echo([&] {
+        std::size_t value;
+        for (std::size_t i = 0; i < trips; i++)
+        {
+            while (!ping.TryPopBatch(&value, 1))
+                std::this_thread::yield();
+            while (!pong.TryPushBatch(&value, 1))
+                std::this_thread::yield();
+        }
+    });
+
+    BENCHMARK_START(Queue_RoundTrip, trips);
+    BENCHMARK_LOOP(Queue_RoundTrip)
+    {
+        std::size_t value = Iteration;
+        while (!ping.TryPushBatch(&value, 1))
+            std::this_thread::yield();
+        while (!pong.TryPopBatch(&value, 1))
+            std::this_thread::yield();
+        if (value != Iteration)
+        {
+            BENCHMARK_FAIL(Queue_RoundTrip);
+            break;
+        }
+    }
+    echo.join();
+    return BENCHMARK_END(Queue_RoundTrip);
+}
+
+/**
+ * Fill a fresh container with a few items and sum them, the pattern of short-lived lists on hot paths
+ * @tparam Vector std::vector or SmallVector
+ * @tparam Count Number of items
+ */
+template <class Vector, std::size_t Count>
+Exi::Unit::BenchmarkResults Benchmark_Vector_Fill()
+{
+    volatile std::size_t sink = 0;
+    BENCHMARK_START(Vector_Fill, 1 << 20);
+    BENCHMARK_LOOP(Vector_Fill)
+    {
+        Vector vector;
+        for (std::size_t i = 0; i < Count; i++)
+            vector.push_back(Iteration + i);
+
+        std::size_t sum = 0;
+        for (auto value : vector)
+            sum += value;
+        sink = sink + sum;
+    }
+    return BENCHMARK_END(Vector_Fill);
+}
+
 bool Benchmark()
 {
     Exi::Unit::RunBenchmark("NumericMap::Find",    Benchmark_NumericMap_Find);
     Exi::Unit::RunBenchmark("NumericMap::GetKeys", Benchmark_NumericMap_GetKeys);
+
+    using Map = Exi::TL::NumericMap<std::size_t, int>;
+    using LegacyMap = Exi::TL::Legacy::NumericMap<std::size_t, int>;
+    Exi::Unit::RunBenchmark("NumericMap::Emplace (10 keys)",         Benchmark_NumericMap_EmplaceKeys<Map, 10>);
+    Exi::Unit::RunBenchmark("Legacy NumericMap::Emplace (10 keys)",  Benchmark_NumericMap_EmplaceKeys<LegacyMap, 10>);
+    Exi::Unit::RunBenchmark("NumericMap::Emplace (1k keys)",         Benchmark_NumericMap_EmplaceKeys<Map, 1000>);
+    Exi::Unit::RunBenchmark("Legacy NumericMap::Emplace (1k keys)",  Benchmark_NumericMap_EmplaceKeys<LegacyMap, 1000>);
+    Exi::Unit::RunBenchmark("NumericMap::Emplace (1M keys)",         Benchmark_NumericMap_EmplaceKeys<Map, 1000000>);
+    Exi::Unit::RunBenchmark("NumericMap::Find (10 keys)",            Benchmark_NumericMap_FindKeys<Map, 10>);
+    Exi::Unit::RunBenchmark("Legacy NumericMap::Find (10 keys)",     Benchmark_NumericMap_FindKeys<LegacyMap, 10>);
+    Exi::Unit::RunBenchmark("NumericMap::Find (1k keys)",            Benchmark_NumericMap_FindKeys<Map, 1000>);
+    Exi::Unit::RunBenchmark("Legacy NumericMap::Find (1k keys)",     Benchmark_NumericMap_FindKeys<LegacyMap, 1000>);
+    Exi::Unit::RunBenchmark("NumericMap::Find (1M keys)",            Benchmark_NumericMap_FindKeys<Map, 1000000>);
+
+    // The legacy map chains every key into 16 buckets, so filling it is quadratic
+    // (~25 s at 100k keys) and a 1M key run would take the better part of an hour
+    printf("Legacy NumericMap (1M keys): skipped, insertion is quadratic\n");
+
+    Exi::Unit::RunBenchmark("NumericMap::Emplace + Erase (1k keys)", Benchmark_NumericMap_EmplaceErase);
+    Exi::Unit::RunBenchmark("LRUCache::TryGet (1024 strings)",       Benchmark_LRUCache_Hit);
+
+    using LockedCache = LockedLRUCache<std::size_t, std::size_t>;
+    using ShardedCache = Exi::TL::ShardedCache<std::size_t, std::size_t>;
+    Exi::Unit::RunBenchmark("Locked LRUCache hits (1 thread)",   Benchmark_Cache_Threads<LockedCache, 1>);
+    Exi::Unit::RunBenchmark("Locked LRUCache hits (4 threads)",  Benchmark_Cache_Threads<LockedCache, 4>);
+    Exi::Unit::RunBenchmark("Locked LRUCache hits (8 threads)",  Benchmark_Cache_Threads<LockedCache, 8>);
+    Exi::Unit::RunBenchmark("ShardedCache hits (1 thread)",      Benchmark_Cache_Threads<ShardedCache, 1>);
+    Exi::Unit::RunBenchmark("ShardedCache hits (4 threads)",     Benchmark_Cache_Threads<ShardedCache, 4>);
+    Exi::Unit::RunBenchmark("ShardedCache hits (8 threads)",     Benchmark_Cache_Threads<ShardedCache, 8>);
+    Exi::Unit::RunBenchmark("ObjectPool::Release + Get (1k live)",   Benchmark_ObjectPool_GetRelease<1000>);
+    Exi::Unit::RunBenchmark("ObjectPool::Release + Get (100k live)", Benchmark_ObjectPool_GetRelease<100000>);
+    Exi::Unit::RunBenchmark("ObjectPool::Release + Get (1M live)",   Benchmark_ObjectPool_GetRelease<1000000>);
+    Exi::Unit::RunBenchmark("ObjectPool::Release + Get (1M live, huge pages)",
+                            Benchmark_ObjectPool_GetRelease<1000000, Exi::TL::PoolBacking::HugePages>);
+    Exi::Unit::RunBenchmark("std::list push + pop (std::allocator)",   Benchmark_ListChurn<std::allocator<PoolObject>>);
+    Exi::Unit::RunBenchmark("std::list push + pop (PoolAllocator)",    Benchmark_ListChurn<Exi::TL::PoolAllocator<PoolObject>>);
+
+    using Locked = LockedObjectPool<PoolObject>;
+    using Concurrent = Exi::TL::ConcurrentObjectPool<PoolObject>;
+    Exi::Unit::RunBenchmark("Locked ObjectPool cross-thread (1 thread)",          Benchmark_ObjectPool_CrossThread<Locked, 1>);
+    Exi::Unit::RunBenchmark("Locked ObjectPool cross-thread (4 threads)",         Benchmark_ObjectPool_CrossThread<Locked, 4>);
+    Exi::Unit::RunBenchmark("Locked ObjectPool cross-thread (8 threads)",         Benchmark_ObjectPool_CrossThread<Locked, 8>);
+    Exi::Unit::RunBenchmark("ConcurrentObjectPool cross-thread (1 thread)",       Benchmark_ObjectPool_CrossThread<Concurrent, 1>);
+    Exi::Unit::RunBenchmark("ConcurrentObjectPool cross-thread (4 threads)",      Benchmark_ObjectPool_CrossThread<Concurrent, 4>);
+    Exi::Unit::RunBenchmark("ConcurrentObjectPool cross-thread (8 threads)",      Benchmark_ObjectPool_CrossThread<Concurrent, 8>);
+
     Exi::Unit::RunBenchmark("FreeMap::Allocate",   Benchmark_FreeMap_Allocate);
+    Exi::Unit::RunBenchmark("FreeMap::Allocate (1M bits, last free)", Benchmark_FreeMap_AllocateFull);
+    Exi::Unit::RunBenchmark("FreeMap::AllocateRange (100 of 64k bits)", Benchmark_FreeMap_AllocateRange);
+
+    using LockedMap = LockedFreeMap<65536>;
+    using AtomicMap = Exi::TL::AtomicFreeMap<65536>;
+    Exi::Unit::RunBenchmark("Locked FreeMap Free + Allocate (1 thread)",    Benchmark_FreeMap_Contention<LockedMap, 1>);
+    Exi::Unit::RunBenchmark("Locked FreeMap Free + Allocate (4 threads)",   Benchmark_FreeMap_Contention<LockedMap, 4>);
+    Exi::Unit::RunBenchmark("Locked FreeMap Free + Allocate (16 threads)",  Benchmark_FreeMap_Contention<LockedMap, 16>);
+    Exi::Unit::RunBenchmark("AtomicFreeMap Free + Allocate (1 thread)",     Benchmark_FreeMap_Contention<AtomicMap, 1>);
+    Exi::Unit::RunBenchmark("AtomicFreeMap Free + Allocate (2 threads)",    Benchmark_FreeMap_Contention<AtomicMap, 2>);
+    Exi::Unit::RunBenchmark("AtomicFreeMap Free + Allocate (4 threads)",    Benchmark_FreeMap_Contention<AtomicMap, 4>);
+    Exi::Unit::RunBenchmark("AtomicFreeMap Free + Allocate (8 threads)",    Benchmark_FreeMap_Contention<AtomicMap, 8>);
+    Exi::Unit::RunBenchmark("AtomicFreeMap Free + Allocate (16 threads)",   Benchmark_FreeMap_Contention<AtomicMap, 16>);
+
+    using Exi::TL::UUID;
+    Exi::Unit::RunBenchmark("UUID::V4 (1 thread)",   Benchmark_UUID_Random<UUID::V4, 1>);
+    Exi::Unit::RunBenchmark("UUID::V4 (4 threads)",  Benchmark_UUID_Random<UUID::V4, 4>);
+    Exi::Unit::RunBenchmark("UUID::V4 (8 threads)",  Benchmark_UUID_Random<UUID::V4, 8>);
+    Exi::Unit::RunBenchmark("UUID::V7 (1 thread)",   Benchmark_UUID_Random<UUID::V7, 1>);
+    Exi::Unit::RunBenchmark("UUID::V7 (4 threads)",  Benchmark_UUID_Random<UUID::V7, 4>);
+    Exi::Unit::RunBenchmark("UUID sort (64k)",       Benchmark_UUID_Sort);
+    Exi::Unit::RunBenchmark("std::unordered_map<UUID> find (100k IDs)",          Benchmark_UUID_Find<std::hash<UUID>>);
+    Exi::Unit::RunBenchmark("std::unordered_map<UUID> find (100k IDs, old hash)", Benchmark_UUID_Find<LegacyUUIDHash>);
+    Exi::Unit::RunBenchmark("UUID format (snprintf)",  Benchmark_UUID_Format<true>);
+    Exi::Unit::RunBenchmark("UUID::ToString",          Benchmark_UUID_Format<false>);
+    Exi::Unit::RunBenchmark("UUID::Format (batch)",    Benchmark_UUID_FormatBatch);
+    Exi::Unit::RunBenchmark("UUID::Parse (batch)",     Benchmark_UUID_ParseBatch);
+
+    using Spsc = Exi::TL::SpscRing<std::size_t>;
+    using Mpmc = Exi::TL::MpmcQueue<std::size_t>;
+    using LockedDeque = LockedQueue<std::size_t>;
+    Exi::Unit::RunBenchmark("SpscRing throughput (1:1)",                  Benchmark_Queue_Throughput<Spsc, 1, 1, 1>);
+    Exi::Unit::RunBenchmark("SpscRing throughput (1:1, batches of 32)",   Benchmark_Queue_Throughput<Spsc, 1, 1, 32>);
+    Exi::Unit::RunBenchmark("Locked queue throughput (4:4)",              Benchmark_Queue_Throughput<LockedDeque, 4, 4, 1>);
+    Exi::Unit::RunBenchmark("MpmcQueue throughput (1:1)",                 Benchmark_Queue_Throughput<Mpmc, 1, 1, 1>);
+    Exi::Unit::RunBenchmark("MpmcQueue throughput (4:4)",                 Benchmark_Queue_Throughput<Mpmc, 4, 4, 1>);
+    Exi::Unit::RunBenchmark("MpmcQueue throughput (4:4, batches of 32)",  Benchmark_Queue_Throughput<Mpmc, 4, 4, 32>);
+    Exi::Unit::RunBenchmark("MpmcQueue throughput (8:8)",                 Benchmark_Queue_Throughput<Mpmc, 8, 8, 1>);
+    Exi::Unit::RunBenchmark("MpmcQueue throughput (15:1)",                Benchmark_Queue_Throughput<Mpmc, 15, 1, 1>);
+    Exi::Unit::RunBenchmark("MpmcQueue throughput (1:15)",                Benchmark_Queue_Throughput<Mpmc, 1, 15, 1>);
+    Exi::Unit::RunBenchmark("SpscRing round trip",                        Benchmark_Queue_RoundTrip<Spsc>);
+    Exi::Unit::RunBenchmark("MpmcQueue round trip",                       Benchmark_Queue_RoundTrip<Mpmc>);
+
+    using Small = Exi::TL::SmallVector<std::size_t, 8>;
+    Exi::Unit::RunBenchmark("std::vector fill (4 items)",    Benchmark_Vector_Fill<std::vector<std::size_t>, 4>);
+    Exi::Unit::RunBenchmark("SmallVector fill (4 items)",    Benchmark_Vector_Fill<Small, 4>);
+    Exi::Unit::RunBenchmark("std::vector fill (32 items)",   Benchmark_Vector_Fill<std::vector<std::size_t>, 32>);
+    Exi::Unit::RunBenchmark("SmallVector fill (32 items)",   Benchmark_Vector_Fill<Small, 32>);
 
     return true;
 }
@@ -1,8 +1,25 @@
 #include <Exile/Unit/Test.hpp>
 #include <Exile/TL/NumericMap.hpp>
+#include <Exile/TL/ConcurrentObjectPool.hpp>
+#include <Exile/TL/PoolAllocator.hpp>
 #include <Exile/TL/FreeMap.hpp>
+#include <Exile/TL/AtomicFreeMap.hpp>
+#include <Exile/TL/NameTable.hpp>
+#include <Exile/TL/LRUCache.hpp>
+#include <Exile/TL/ShardedCache.hpp>
+#include <Exile/TL/SpscRing.hpp>
+#include <Exile/TL/MpmcQueue.hpp>
+#include <Exile/TL/SmallVector.hpp>
+#include <Exile/TL/ObjectPool.hpp>
 #include <Exile/TL/ByteUtils.hpp>
 #include <Exile/TL/UUID.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <thread>
 #include <unordered_set>
 
 extern bool Benchmark();
@@ -52,10 +69,335 @@ bool Test_NumericMap_GetKeys()
 bool Test_NumericMap_Contract()
 {
     Exi::TL::NumericMap<std::size_t, int> map;
-    map.Expand();
+    map.Reserve(64);
     map.Emplace(1, 1);
+    const std::size_t capacity = map.GetCapacity();
     int freed = map.Contract();
-    return freed == (map.Rows * (map.Columns - 1));
+    return freed == (capacity - Exi::TL::NumericMap<std::size_t, int>::GroupSize) && map.Contains(1);
+}
+
+bool Test_NumericMap_MemoryUsage()
+{
+    using Map = Exi::TL::NumericMap<std::size_t, int>;
+    Map map;
+    if (map.GetMemoryUsage() != 0)
+        return false;
+
+    map.Emplace(1, 1);
+    map.Emplace(1, 2);
+    map.Contract();
+    return map.GetMemoryUsage() == Map::GroupSize * (1 + sizeof(Map::KeySlot)) + 2 * sizeof(Map::ValueNode);
+}
+
+bool Test_NumericMap_Erase()
+{
+    Exi::TL::NumericMap<std::size_t, int> map;
+    for (int i = 0; i < 100; i++)
+    {
+        map.Emplace(i, i);
+        map.Emplace(i, -i);
+    }
+
+    // Erasing the head, then the tail of a chain, then a whole key
+    if (!map.Erase(5, 5) || map.Erase(5, 5) || map.Count(5) != 1 ||
+        !map.Erase(6, -6) || map.Count(6) != 1 ||
+        map.Erase(7) != 2 || map.Contains(7) || map.Erase(7) != 0)
+        return false;
+
+    int value;
+    if (map.Find(5, &value, 1) != 1 || value != -5 || !map.Erase(5, -5) || map.Contains(5))
+        return false;
+
+    // Freed value nodes are reused before the pool grows
+    const std::size_t memory = map.GetMemoryUsage();
+    map.Emplace(1000, 1);
+    map.Emplace(1001, 2);
+    map.Emplace(1001, 3);
+    map.Emplace(1001, 4);
+    map.Emplace(1002, 5);
+    if (map.GetMemoryUsage() != memory || map.GetKeys() != 101)
+        return false;
+
+    // Repeatedly erasing and inserting must not grow the table
+    const std::size_t capacity = map.GetCapacity();
+    for (int i = 0; i < 10000; i++)
+    {
+        map.Emplace(2000 + i, i);
+        map.Erase(2000 + i);
+    }
+    return map.GetCapacity() == capacity && map.Count(1001) == 3 && map.Count(6) == 1;
+}
+
+bool Test_NumericMap_Iterate()
+{
+    Exi::TL::NumericMap<std::size_t, int> map;
+    std::size_t keySum = 0;
+    int valueSum = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        map.Emplace(i, i);
+        map.Emplace(i, 1000);
+    }
+    map.Erase(10);
+
+    for (auto [key, value] : map)
+    {
+        keySum += key;
+        valueSum += value;
+        value = 0;
+    }
+
+    int range[3] = { 0 };
+    int count = 0;
+    map.Emplace(20, 2000);
+    for (auto [key, value] : map.EqualRange(20))
+        range[count++] = value;
+
+    // Values of each key stay in insertion order, and compacting keeps them
+    map.Contract();
+    int compacted[3] = { 0 };
+    int compactedCount = 0;
+    for (auto [key, value] : std::as_const(map).EqualRange(20))
+        compacted[compactedCount++] = value;
+
+    return keySum == 63 * 64 - 2 * 10 && valueSum == (63 * 64 / 2 - 10) + 1000 * 63 &&
+        count == 3 && range[0] == 0 && range[2] == 2000 &&
+        compactedCount == 3 && compacted[2] == 2000 && map.EqualRange(10).empty();
+}
+
+bool Test_NameTable_Intern()
+{
+    Exi::TL::NameTable table;
+    const auto boss = table.Intern("Boss");
+    const auto minion = table.Intern(std::string("Minion"));
+
+    return table.Intern("") == Exi::TL::NameTable::EmptyName &&
+        table.Intern("Boss") == boss && boss != minion &&
+        table.Get(boss) == "Boss" && table.Get(minion) == "Minion" &&
+        table.Find("Minion") == minion && table.Find("Nobody") == Exi::TL::NameTable::InvalidName &&
+        table.GetCount() == 3;
+}
+
+bool Test_LRUCache_Evict()
+{
+    Exi::TL::LRUCache<std::string, int> cache(3);
+    cache.Put("a", 1);
+    cache.Put("b", 2);
+    cache.Put("c", 3);
+
+    // Touching "a" makes "b" the least recently used entry
+    const std::string_view a = "a";
+    const int* value = cache.TryGet(a);
+    if (!value || *value != 1)
+        return false;
+
+    cache.Put("d", 4);
+    if (cache.Contains("b") || !cache.Contains(a) || cache.Size() != 3)
+        return false;
+
+    // Replacing a value refreshes it too, so "c" goes next
+    cache.Put("a", 10);
+    cache.Put("e", 5);
+    bool threw = false;
+    try { cache.Get("c"); } catch (const std::out_of_range&) { threw = true; }
+    if (!threw || cache.Get(a) != 10 || cache.TryGet("c") != nullptr)
+        return false;
+
+    cache.Clear();
+    cache.Put("f", 6);
+    return !cache.Contains(a) && cache.Get(std::string_view("f")) == 6 && cache.Size() == 1;
+}
+
+bool Test_ShardedCache_Evict()
+{
+    // One shard, so eviction order is fully determined
+    Exi::TL::ShardedCache<std::string, int, Exi::TL::CacheHash<std::string>, 1> cache(10);
+    cache.Put("a", 1, 4);
+    cache.Put("b", 2, 3);
+    cache.Put("c", 3, 3);
+
+    // "a" gets a second chance, so making room for "d" evicts "b" instead
+    int value = 0;
+    if (!cache.TryGet(std::string_view("a"), value) || value != 1)
+        return false;
+    cache.Put("d", 4, 2);
+    if (cache.Contains("b") || !cache.Contains("a") || cache.GetWeight() != 9)
+        return false;
+
+    // Oversized entries are refused, replacing one updates its weight
+    if (cache.Put("huge", 0, 11) || !cache.Put("a", 10, 1) || cache.GetWeight() != 6)
+        return false;
+    return cache.Erase("c") && !cache.Erase("c") && cache.Size() == 2 &&
+        cache.TryGet("a", value) && value == 10;
+}
+
+bool Test_ShardedCache_Threads()
+{
+    constexpr int threads = 4;
+    constexpr int keys = 2000;
+    Exi::TL::ShardedCache<std::size_t, std::size_t> cache(1000);
+    std::atomic_bool valid = true;
+
+    // Values always match their keys, no matter which thread put them or what was evicted
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t] {
+            for (std::size_t i = 0; i < 20000; i++)
+            {
+                const std::size_t key = (i * 7 + t) % keys;
+                std::size_t value;
+                if (cache.TryGet(key, value))
+                {
+                    if (value != key * 3)
+                        valid = false;
+                }
+                else
+                {
+                    cache.Put(key, key * 3);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    return valid && cache.Size() <= 16 * cache.GetShardBudget() && cache.Size() == cache.GetWeight();
+}
+
+bool Test_ObjectPool_Release()
+{
+    struct Object
+    {
+        explicit Object(int value) : Value(value) { }
+        int Value;
+        char Padding[60];
+    };
+
+    using Pool = Exi::TL::ObjectPool<Object>;
+    Pool pool, other;
+    std::vector<Object*> objects;
+    for (int i = 0; i < 10000; i++)
+        objects.push_back(pool.Get(i));
+
+    if (pool.GetBlockCount() != (10000 + Pool::ObjectsPerBlock - 1) / Pool::ObjectsPerBlock)
+        return false;
+
+    // Objects are only released to the pool that allocated them, and only once
+    if (other.Release(objects[0]) || !pool.Release(objects[0]) || pool.Release(objects[0]))
+        return false;
+
+    for (int i = 2; i < 10000; i += 2)
+    {
+        if (objects[i]->Value != i || !pool.Release(objects[i]))
+            return false;
+    }
+
+    // Released slots are reused before any new block is added
+    const std::size_t blocks = pool.GetBlockCount();
+    for (int i = 0; i < 5000; i++)
+        pool.Get(-i);
+    return pool.GetBlockCount() == blocks && pool.GetLiveCount() == 10000 && objects[1]->Value == 1;
+}
+
+bool Test_ObjectPool_HugePages()
+{
+    Exi::TL::ObjectPool<std::size_t> pool(Exi::TL::PoolBacking::HugePages);
+    std::vector<std::size_t*> objects;
+    for (std::size_t i = 0; i < 300000; i++)
+        objects.push_back(pool.Get(i));
+    for (std::size_t i = 0; i < objects.size(); i += 2)
+    {
+        if (*objects[i] != i || !pool.Release(objects[i]))
+            return false;
+    }
+
+    auto stats = pool.GetStats();
+#ifdef __linux__
+    // 300k objects take several 4 KiB blocks per 2 MiB region
+    if (stats.HugePageBytes == 0 || stats.HugePageBytes < stats.BlockBytes)
+        return false;
+#endif
+    return stats.LiveObjects == 150000 && stats.PeakLiveObjects == 300000 &&
+        stats.Capacity >= 300000 && stats.Blocks == pool.GetBlockCount();
+}
+
+bool Test_PoolAllocator_Containers()
+{
+    using Allocator = Exi::TL::PoolAllocator<std::pair<const int, int>>;
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, Allocator> map;
+    std::list<int, Exi::TL::PoolAllocator<int>> list;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        map.emplace(i, i * 2);
+        list.push_back(i);
+    }
+    for (int i = 0; i < 1000; i += 2)
+        map.erase(i);
+    list.remove_if([](int i) { return i % 2 == 0; });
+
+    // Single objects come from the pool, arrays from the heap
+    Exi::TL::PoolAllocator<double> direct;
+    double* single = direct.allocate(1);
+    double* array = direct.allocate(64);
+    const auto stats = Exi::TL::PoolAllocator<double>::GetStats();
+    direct.deallocate(single, 1);
+    direct.deallocate(array, 64);
+
+    return map.size() == 500 && map.at(999) == 1998 && list.size() == 500 && list.back() == 999 &&
+        stats.Blocks == 1 && stats.LiveObjects >= 1 && stats.LiveObjects < 64 * 2 &&
+        direct == Exi::TL::PoolAllocator<int>();
+}
+
+bool Test_ConcurrentObjectPool_CrossThread()
+{
+    constexpr int threads = 4;
+    constexpr int perThread = 5000;
+    Exi::TL::ConcurrentObjectPool<std::size_t> pool;
+    std::vector<std::size_t*> objects[threads];
+
+    auto run = [&](auto&& fn) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+            workers.emplace_back(fn, t);
+        for (auto& worker : workers)
+            worker.join();
+    };
+
+    run([&](int t) {
+        for (int i = 0; i < perThread; i++)
+            objects[t].push_back(pool.Get(t * perThread + i));
+    });
+
+    std::unordered_set<std::size_t*> unique;
+    for (auto& list : objects)
+        unique.insert(list.begin(), list.end());
+    if (unique.size() != threads * perThread)
+        return false;
+
+    // Every thread releases the objects another thread got
+    std::atomic_bool valid = true;
+    run([&](int t) {
+        const int owner = (t + 1) % threads;
+        for (int i = 0; i < perThread; i++)
+        {
+            if (*objects[owner][i] != owner * perThread + i || !pool.Release(objects[owner][i]))
+                valid = false;
+        }
+    });
+
+    // Released slots come back through the depot instead of new blocks
+    const std::size_t blocks = pool.GetBlockCount();
+    run([&](int t) {
+        for (int i = 0; i < perThread; i++)
+            objects[t][i] = pool.Get(0);
+    });
+
+    // Objects of another pool are refused
+    Exi::TL::ConcurrentObjectPool<std::size_t> other;
+    std::size_t* stranger = other.Get(0);
+    return valid && pool.GetBlockCount() == blocks && !pool.Release(stranger) && other.Release(stranger);
 }
 
 bool Test_FreeMap_Allocate()
@@ -70,13 +412,345 @@ bool Test_FreeMap_Allocate()
     return index == (count - 1);
 }
 
+bool Test_FreeMap_Tail()
+{
+    // Bits past the end of the map must never be handed out
+    Exi::TL::FreeMap<100> map;
+    for (int i = 0; i < 100; i++)
+    {
+        if (map.Allocate() != i)
+            return false;
+    }
+    return map.Allocate() == Exi::TL::FreeMap<100>::InvalidIndex && map.GetFreeCount() == 0;
+}
+
+bool Test_FreeMap_Hierarchy()
+{
+    using Map = Exi::TL::FreeMap<1 << 20>;
+    auto map = std::make_unique<Map>();
+    for (int i = 0; i < (1 << 20); i++)
+        map->Allocate();
+    if (map->Allocate() != Map::InvalidIndex)
+        return false;
+
+    // Lowest free index first, across summary and top elements
+    map->Free(900000);
+    map->Free(300000);
+    map->Free(700000);
+    if (map->Allocate() != 300000 || map->Allocate() != 700000 || map->Allocate() != 900000)
+        return false;
+
+    map->FreeAll();
+    return map->GetFreeCount() == (1 << 20) && map->Allocate() == 0;
+}
+
+bool Test_FreeMap_AllocateRange()
+{
+    Exi::TL::FreeMap<4096> map;
+    if (map.AllocateRange(100) != 0 || map.AllocateRange(50) != 100)
+        return false;
+
+    // A hole too small for the request is skipped
+    map.FreeRange(10, 20);
+    if (map.AllocateRange(30) != 150 || map.AllocateRange(20) != 10)
+        return false;
+
+    // Runs may straddle elements, and fail once nothing large enough is left
+    map.FreeRange(60, 130);
+    const auto index = map.AllocateRange(130);
+    return index == 60 && map.IsFree(59) == false && map.IsFree(190) &&
+        map.AllocateRange(5000) == Exi::TL::FreeMap<4096>::InvalidIndex &&
+        map.GetFreeCount() == 4096 - 190 && map.AllocateRange(4096 - 190) == 190;
+}
+
+bool Test_AtomicFreeMap_Concurrent()
+{
+    constexpr int threads = 4;
+    constexpr int bits = 4000;
+    Exi::TL::AtomicFreeMap<bits> map;
+    std::vector<std::size_t> indices[threads];
+
+    auto run = [&](auto&& fn) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+            workers.emplace_back(fn, t);
+        for (auto& worker : workers)
+            worker.join();
+    };
+
+    // Threads drain the map between them, then churn through what they hold
+    run([&](int t) {
+        for (std::size_t i; (i = map.Allocate()) != map.InvalidIndex; )
+            indices[t].push_back(i);
+        for (int round = 0; round < 1000 && !indices[t].empty(); round++)
+        {
+            // A scan can miss a bit freed behind it while the map is full, so retry
+            auto& index = indices[t][round % indices[t].size()];
+            map.Free(index);
+            while ((index = map.Allocate()) == map.InvalidIndex) { }
+        }
+    });
+
+    std::unordered_set<std::size_t> unique;
+    for (auto& list : indices)
+        unique.insert(list.begin(), list.end());
+    if (unique.size() != bits || *std::max_element(unique.begin(), unique.end()) != bits - 1 ||
+        map.GetFreeCount() != 0 || map.Allocate() != map.InvalidIndex)
+        return false;
+
+    std::atomic_bool valid = true;
+    run([&](int t) {
+        for (auto index : indices[t])
+        {
+            if (!map.Free(index))
+                valid = false;
+        }
+    });
+
+    if (!valid || map.GetFreeCount() != bits || map.Free(0))
+        return false;
+
+    // Ranges never straddle elements, so 64 fit only at element boundaries
+    const auto range = map.AllocateRange(64);
+    return range % 64 == 0 && !map.IsFree(range) && !map.IsFree(range + 63) &&
+        map.AllocateRange(65) == map.InvalidIndex;
+}
+
+bool Test_SpscRing()
+{
+    constexpr std::size_t count = 100000;
+    Exi::TL::SpscRing<std::size_t> ring(100);
+    if (ring.GetCapacity() != 128)
+        return false;
+
+    // Items arrive in order, mixing single and batch calls on both sides across many laps
+    std::thread producer([&] {
+        std::size_t next = 0, batch[7];
+        while (next < count)
+        {
+            std::size_t pushed = 0;
+            if (next % 3 == 0)
+            {
+                const std::size_t size = std::min<std::size_t>(7, count - next);
+                for (std::size_t i = 0; i < size; i++)
+                    batch[i] = next + i;
+                pushed = ring.TryPushBatch(batch, size);
+            }
+            else
+            {
+                pushed = ring.TryPush(next);
+            }
+
+            next += pushed;
+            if (!pushed)
+                std::this_thread::yield();
+        }
+    });
+
+    bool valid = true;
+    std::size_t expected = 0, batch[5];
+    while (expected < count)
+    {
+        std::size_t popped = 0;
+        if (expected % 2 == 0)
+        {
+            popped = ring.TryPopBatch(batch, 5);
+        }
+        else if (ring.TryPop(batch[0]))
+        {
+            popped = 1;
+        }
+
+        for (std::size_t i = 0; i < popped; i++)
+            valid &= batch[i] == expected++;
+        if (!popped)
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    // Leftover items are destroyed with the ring
+    auto shared = std::make_shared<int>(0);
+    {
+        Exi::TL::SpscRing<std::shared_ptr<int>> owners(4);
+        owners.TryPush(shared);
+        owners.TryPush(shared);
+    }
+    return valid && ring.Empty() && shared.use_count() == 1;
+}
+
+bool Test_MpmcQueue()
+{
+    constexpr int producers = 4, consumers = 4;
+    constexpr std::size_t perProducer = 50000;
+    Exi::TL::MpmcQueue<std::size_t> queue(256);
+    std::vector<std::atomic<int>> seen(producers * perProducer);
+    std::atomic<std::size_t> consumed = 0;
+
+    // Every item is taken exactly once, in order per producer
+    std::vector<std::thread> workers;
+    std::atomic_bool valid = true;
+    for (int p = 0; p < producers; p++)
+    {
+        workers.emplace_back([&, p] {
+            std::size_t next = p * perProducer;
+            const std::size_t end = next + perProducer;
+            std::size_t batch[8];
+            while (next < end)
+            {
+                const std::size_t size = std::min<std::size_t>(p % 2 ? 8 : 1, end - next);
+                for (std::size_t i = 0; i < size; i++)
+                    batch[i] = next + i;
+                const std::size_t pushed = queue.TryPushBatch(batch, size);
+                if (!pushed)
+                    std::this_thread::yield();
+                next += pushed;
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++)
+    {
+        workers.emplace_back([&, c] {
+            std::vector<std::size_t> last(producers, SIZE_MAX);
+            std::size_t batch[8];
+            while (consumed.load() < producers * perProducer)
+            {
+                const std::size_t size = c % 2 ? queue.TryPopBatch(batch, 8) : queue.TryPop(batch[0]);
+                if (!size)
+                    std::this_thread::yield();
+                for (std::size_t i = 0; i < size; i++)
+                {
+                    const std::size_t producer = batch[i] / perProducer;
+                    if (seen[batch[i]]++ != 0 || (last[producer] != SIZE_MAX && last[producer] > batch[i]))
+                        valid = false;
+                    last[producer] = batch[i];
+                }
+                consumed += size;
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    // Full and empty queues refuse pushes and pops
+    Exi::TL::MpmcQueue<std::string> small(2);
+    std::string value;
+    const std::string items[] = { "a", "b", "c" };
+    std::size_t leftover;
+    return valid && queue.Empty() && !queue.TryPop(leftover) &&
+        small.TryPushBatch(items, 3) == 2 && !small.TryPush("d") &&
+        small.TryPop(value) && value == "a" && small.TryPush("d") && small.Size() == 2;
+}
+
+bool Test_MpmcQueueBatchBounds()
+{
+    constexpr int threads = 4;
+    constexpr std::size_t capacity = 1 << 18, rounds = 200;
+    Exi::TL::MpmcQueue<std::size_t> queue(capacity);
+    std::atomic_bool valid = true;
+
+    // With only one side running, a batch returning zero means the queue really is full or empty:
+    // the other counter can't move, so a later snapshot still short of full or empty proves a
+    // spurious zero
+    const auto run = [&](auto&& work) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+            workers.emplace_back(work);
+        for (auto& worker : workers)
+            worker.join();
+    };
+    for (std::size_t round = 0; round < rounds && valid; round++)
+    {
+        run([&] {
+            const std::size_t batch[3] = { 1, 2, 3 };
+            while (queue.TryPushBatch(batch, 3))
+                ;
+            if (queue.Size() != capacity)
+                valid = false;
+        });
+        run([&] {
+            std::size_t batch[3];
+            while (queue.TryPopBatch(batch, 3))
+                ;
+            if (!queue.Empty())
+                valid = false;
+        });
+    }
+    return valid;
+}
+
+/** Takes any inline capacity, the way callers hand in their own stack buffers */
+static void AppendNumbers(Exi::TL::SmallVectorBase<std::string>& out, int count)
+{
+    for (int i = 0; i < count; i++)
+        out.push_back(std::to_string(i));
+}
+
+bool Test_SmallVector()
+{
+    // Trivially copyable items stay inline, then realloc once they spill
+    Exi::TL::SmallVector<int, 4> ints = { 1, 2, 3, 4 };
+    if (!ints.IsInline() || ints.capacity() != 4)
+        return false;
+    ints.push_back(ints[0]);
+    for (int i = 6; i <= 100; i++)
+        ints.push_back(i);
+    ints.erase(ints.begin() + 5, ints.end() - 1);
+    if (ints.IsInline() || ints.size() != 6 || ints[4] != 1 || ints.back() != 100)
+        return false;
+
+    // Non-trivial items are moved and destroyed properly in both storage modes
+    Exi::TL::SmallVector<std::string, 2> inlined;
+    AppendNumbers(inlined, 2);
+    Exi::TL::SmallVector<std::string, 2> spilled;
+    AppendNumbers(spilled, 40);
+    spilled.erase(spilled.begin());
+    if (!inlined.IsInline() || spilled.IsInline() || spilled.front() != "1" || spilled.size() != 39)
+        return false;
+
+    const std::string* heap = spilled.data();
+    Exi::TL::SmallVector<std::string, 2> stolen(std::move(spilled));
+    Exi::TL::SmallVector<std::string, 2> moved(std::move(inlined));
+    if (stolen.data() != heap || !spilled.empty() || !inlined.empty() || moved.size() != 2 || moved[1] != "1")
+        return false;
+
+    // Moved-from vectors stay usable and get their inline capacity back
+    if (spilled.capacity() != 2 || inlined.capacity() != 2)
+        return false;
+    spilled.push_back("again");
+    Exi::TL::SmallVector<std::string, 2> copy(stolen);
+    copy.resize(stolen.size() + 1);
+    moved = std::move(copy);
+    return spilled.size() == 1 && spilled[0] == "again" && spilled.IsInline() &&
+        copy.IsInline() && copy.capacity() == 2 && moved.size() == stolen.size() + 1 &&
+        moved.back().empty() && std::equal(stolen.begin(), stolen.end(), moved.begin());
+}
+
 int main(int argc, const char** argv)
 {
     Exi::Unit::Tests tests ({
         { "NumericMap_Find", Test_NumericMap_Find },
         { "NumericMap_GetKeys", Test_NumericMap_GetKeys },
         { "NumericMap_Contract", Test_NumericMap_Contract },
+        { "NumericMap_MemoryUsage", Test_NumericMap_MemoryUsage },
+        { "NumericMap_Erase", Test_NumericMap_Erase },
+        { "NumericMap_Iterate", Test_NumericMap_Iterate },
+        { "NameTable_Intern", Test_NameTable_Intern },
+        { "LRUCache_Evict", Test_LRUCache_Evict },
+        { "ShardedCache_Evict", Test_ShardedCache_Evict },
+        { "ShardedCache_Threads", Test_ShardedCache_Threads },
+        { "ObjectPool_Release", Test_ObjectPool_Release },
+        { "ObjectPool_HugePages", Test_ObjectPool_HugePages },
+        { "PoolAllocator_Containers", Test_PoolAllocator_Containers },
+        { "ConcurrentObjectPool_CrossThread", Test_ConcurrentObjectPool_CrossThread },
         { "FreeMap_Allocate", Test_FreeMap_Allocate },
+        { "FreeMap_Tail", Test_FreeMap_Tail },
+        { "FreeMap_Hierarchy", Test_FreeMap_Hierarchy },
+        { "FreeMap_AllocateRange", Test_FreeMap_AllocateRange },
+        { "AtomicFreeMap_Concurrent", Test_AtomicFreeMap_Concurrent },
+        { "SpscRing", Test_SpscRing },
+        { "MpmcQueue", Test_MpmcQueue },
+        { "MpmcQueueBatchBounds", Test_MpmcQueueBatchBounds },
+        { "SmallVector", Test_SmallVector },
         { "Benchmark", Benchmark }
     });
 
@@ -99,5 +773,145 @@ int main(int argc, const char** argv)
         return true;
     });
 
+    tests.Add("UUID_V4", []{
+        for (int i = 0; i < 1000; i++)
+        {
+            const auto uuid = Exi::TL::UUID::V4();
+            const auto string = uuid.ToString();
+            if ((uuid.c >> 12) != 4 || ((uuid.d >> 14) & 3) != 2 || string[15] != '4')
+                return false;
+        }
+        return true;
+    });
+
+    tests.Add("UUID_Seed", []{
+        // Seeding is per thread, so another thread generating doesn't disturb the sequence
+        Exi::TL::UUID::Seed(1234);
+        const auto first = Exi::TL::UUID::Random();
+        std::thread([]{
+            for (int i = 0; i < 100; i++)
+                Exi::TL::UUID::Random();
+        }).join();
+        const auto second = Exi::TL::UUID::Random();
+
+        Exi::TL::UUID::Seed(1234);
+        return Exi::TL::UUID::Random() == first && Exi::TL::UUID::Random() == second && first != second;
+    });
+
+    tests.Add("UUID_V7", []{
+        using namespace std::chrono;
+        const auto now = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+
+        // Far more than 4096 per millisecond, so the counter overflows into later timestamps
+        auto last = Exi::TL::UUID::V7();
+        for (int i = 0; i < 100000; i++)
+        {
+            const auto uuid = Exi::TL::UUID::V7();
+            if (!(last < uuid) || (uuid.c >> 12) != 7 || ((uuid.d >> 14) & 3) != 2)
+                return false;
+            last = uuid;
+        }
+        return last.GetTimestamp() >= now && last.GetTimestamp() < now + 60000;
+    });
+
+    tests.Add("UUID_Order", []{
+        // Comparisons agree with the string forms
+        for (int i = 0; i < 10000; i++)
+        {
+            const auto x = Exi::TL::UUID::Random(), y = Exi::TL::UUID::Random();
+            if ((x < y) != (x.ToString() < y.ToString()) || (x <=> x) != 0)
+                return false;
+        }
+        const Exi::TL::UUID low(1, 0, 0, 0xFFFFFFFFFFFF0000), high(1, 0, 0, 1);
+        return low < high;
+    });
+
+    tests.Add("UUID_HashDistribution", []{
+        // Entity-style IDs share a prefix and count up, V7 ones count up in their top bits,
+        // both should spread over the low bits buckets use and the high bits shards use
+        constexpr std::size_t count = 1 << 16, buckets = 1024;
+        std::vector<Exi::TL::UUID> sets[3];
+        for (std::size_t i = 0; i < count; i++)
+        {
+            sets[0].emplace_back(0x12345678, 0x9ABC, 0xDEF0, std::rotl(uint64_t(i), 16));
+            sets[1].push_back(Exi::TL::UUID::V7());
+            sets[2].push_back(Exi::TL::UUID::Random());
+        }
+
+        for (const auto& set : sets)
+        {
+            std::vector<std::size_t> low(buckets), high(buckets);
+            for (const auto& uuid : set)
+            {
+                const std::size_t h = std::hash<Exi::TL::UUID>()(uuid);
+                low[h % buckets]++;
+                high[h >> 54]++;
+            }
+
+            // 64 per bucket on average, a uniform hash stays well within 64 +/- 40
+            for (const auto* loads : { &low, &high })
+            {
+                const auto [min, max] = std::minmax_element(loads->begin(), loads->end());
+                if (*min < 24 || *max > 104)
+                    return false;
+            }
+        }
+        return true;
+    });
+
+    tests.Add("UUID_Format", []{
+        const Exi::TL::UUID uuid(0x0123ABCD, 0x4567, 0x89EF, 0xFEDCBA9876543210);
+        if (uuid.ToString() != "{0123ABCD-4567-89EF-3210-FEDCBA987654}")
+            return false;
+
+        // Batches match formatting one at a time
+        std::vector<Exi::TL::UUID> uuids(100);
+        for (auto& u : uuids)
+            u = Exi::TL::UUID::Random();
+        std::string batch(uuids.size() * Exi::TL::UUID::StringLength, ' ');
+        Exi::TL::UUID::Format(uuids.data(), uuids.size(), batch.data());
+        for (std::size_t i = 0; i < uuids.size(); i++)
+        {
+            char buffer[39];
+            uuids[i].ToString(buffer);
+            if (batch.compare(i * Exi::TL::UUID::StringLength, Exi::TL::UUID::StringLength, buffer) != 0)
+                return false;
+        }
+        return true;
+    });
+
+    tests.Add("UUID_Parse", []{
+        const Exi::TL::UUID expected(0x0123ABCD, 0x4567, 0x89EF, 0xFEDCBA9876543210);
+        Exi::TL::UUID uuid;
+        if (!Exi::TL::UUID::Parse("{0123ABCD-4567-89EF-3210-FEDCBA987654}", uuid) || uuid != expected ||
+            !Exi::TL::UUID::Parse("0123abcd-4567-89ef-3210-fedcba987654", uuid) || uuid != expected)
+            return false;
+
+        // Bad digits, misplaced dashes, unbalanced braces and wrong lengths are all rejected
+        for (const char* text : { "{0123ABCD-4567-89EF-3210-FEDCBA98765G}", "0123ABCD-4567-89EF-3210-FEDCBA98765:",
+                                  "0123ABCD-4567-89EF-3210F-EDCBA987654", "{0123ABCD-4567-89EF-3210-FEDCBA987654",
+                                  "0123ABCD-4567-89EF-3210-FEDCBA98765", "0123ABCD-4567-89EF-3210-FEDCBA98765 ",
+                                  "0123ABCD-4567-89EF-3210-FEDCBA98765\xC5" })
+        {
+            if (Exi::TL::UUID::Parse(text, uuid))
+                return false;
+        }
+
+        // Round trips, one at a time and in batches, stopping at the first bad string
+        std::vector<Exi::TL::UUID> uuids(100), parsed(100);
+        for (auto& u : uuids)
+        {
+            u = Exi::TL::UUID::Random();
+            if (!Exi::TL::UUID::Parse(u.ToString(), uuid) || uuid != u)
+                return false;
+        }
+        std::string batch(uuids.size() * Exi::TL::UUID::StringLength, ' ');
+        Exi::TL::UUID::Format(uuids.data(), uuids.size(), batch.data());
+        if (Exi::TL::UUID::Parse(batch.data(), uuids.size(), parsed.data()) != uuids.size() || parsed != uuids)
+            return false;
+        batch[50 * Exi::TL::UUID::StringLength + 5] = 'x';
+        return Exi::TL::UUID::Parse(batch.data(), uuids.size(), parsed.data()) == 50;
+    });
+
     return tests.Execute(argc, argv);
 }